@@ -0,0 +1,87 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_ALLOC_COUNT_H
+#define DPLL_ALLOC_COUNT_H
+
+// Heap allocation counters.
+// NOTE: the program is to be linked with
+//       -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=aligned_alloc,--wrap=free
+//       so that the allocator calls of the program go through the wrappers.
+
+#include <stdlib.h>
+#include <stdatomic.h>
+
+typedef struct
+{
+    size_t allocations;
+    size_t frees;
+} ALLOC_COUNTERS;
+
+atomic_size_t alloc_allocations;
+atomic_size_t alloc_frees;
+
+// Allocations and deallocations of the current thread:
+_Thread_local size_t alloc_thread_allocations;
+_Thread_local size_t alloc_thread_frees;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t num, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_aligned_alloc(size_t alignment, size_t size);
+void  __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_allocations, 1U, memory_order_relaxed);
+    alloc_thread_allocations += 1U;
+
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t num, size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_allocations, 1U, memory_order_relaxed);
+    alloc_thread_allocations += 1U;
+
+    return __real_calloc(num, size);
+}
+
+// NOTE: every reallocation is counted as it may move the memory block.
+void* __wrap_realloc(void* ptr, size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_allocations, 1U, memory_order_relaxed);
+    alloc_thread_allocations += 1U;
+
+    return __real_realloc(ptr, size);
+}
+
+void* __wrap_aligned_alloc(size_t alignment, size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_allocations, 1U, memory_order_relaxed);
+    alloc_thread_allocations += 1U;
+
+    return __real_aligned_alloc(alignment, size);
+}
+
+void __wrap_free(void* ptr)
+{
+    if (ptr != NULL)
+    {
+        atomic_fetch_add_explicit(&alloc_frees, 1U, memory_order_relaxed);
+        alloc_thread_frees += 1U;
+    }
+
+    __real_free(ptr);
+}
+
+ALLOC_COUNTERS ALLOC_COUNTERS_get(void)
+{
+    ALLOC_COUNTERS counters =
+    {
+        .allocations = atomic_load_explicit(&alloc_allocations, memory_order_relaxed),
+        .frees       = atomic_load_explicit(&alloc_frees,       memory_order_relaxed)
+    };
+
+    return counters;
+}
+
+#endif // DPLL_ALLOC_COUNT_H
@@ -0,0 +1,209 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_ARENA_H
+#define DPLL_ARENA_H
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "utils.h"
+
+//==================//
+// Region allocator //
+//==================//
+
+// Memory is handed out from a list of chunks by bumping a pointer.
+// Individual blocks are never freed: the whole region is released at once.
+typedef struct ARENA_CHUNK
+{
+    struct ARENA_CHUNK* next;
+
+    // Chunk capacity and the number of bytes handed out (measured in bytes):
+    size_t capacity;
+    size_t used;
+
+    max_align_t data[];
+} ARENA_CHUNK;
+
+typedef struct
+{
+    // Chunk being filled (head of the chunk list):
+    ARENA_CHUNK* chunks;
+
+    // The most recent allocation (may be extended in place):
+    char*  last;
+    size_t last_size;
+
+    // Capacity of the first chunk:
+    size_t chunk_size;
+
+    // Memory accounting (measured in bytes):
+    size_t current;
+    size_t peak;
+    size_t reserved;
+} ARENA;
+
+#define ARENA_ALIGNMENT  (sizeof(max_align_t))
+#define ARENA_CHUNK_SIZE (64U * 1024U)
+
+size_t ARENA_align(size_t size)
+{
+    return (size + ARENA_ALIGNMENT - 1U) & ~(ARENA_ALIGNMENT - 1U);
+}
+
+// Initialize an empty region.
+// NOTE: chunks are allocated on demand.
+void ARENA_init(ARENA* arena, size_t chunk_size)
+{
+    arena->chunks     = NULL;
+    arena->last       = NULL;
+    arena->last_size  = 0U;
+    arena->chunk_size = (chunk_size == 0U)? ARENA_CHUNK_SIZE : ARENA_align(chunk_size);
+    arena->current    = 0U;
+    arena->peak       = 0U;
+    arena->reserved   = 0U;
+}
+
+// Append a chunk that holds at least the given number of bytes.
+// NOTE: this function is for internal use only.
+void ARENA_grow(ARENA* arena, size_t size)
+{
+    // Chunks grow geometrically to keep the chunk list short:
+    size_t capacity = (arena->chunks == NULL)? arena->chunk_size : 2U * arena->chunks->capacity;
+    if (capacity < size)
+    {
+        capacity = size;
+    }
+
+    ARENA_CHUNK* chunk = malloc(sizeof(ARENA_CHUNK) + capacity);
+    VERIFY_CONTRACT(chunk != NULL,
+        "[%s] Unable to allocate chunk of %zu bytes\n", "ARENA_grow", capacity);
+
+    chunk->next     = arena->chunks;
+    chunk->capacity = capacity;
+    chunk->used     = 0U;
+
+    arena->chunks    = chunk;
+    arena->reserved += capacity;
+}
+
+void* ARENA_alloc(ARENA* arena, size_t size)
+{
+    size = ARENA_align((size == 0U)? 1U : size);
+
+    if (arena->chunks == NULL || arena->chunks->capacity - arena->chunks->used < size)
+    {
+        ARENA_grow(arena, size);
+    }
+
+    ARENA_CHUNK* chunk = arena->chunks;
+
+    char* block = (char*) chunk->data + chunk->used;
+    chunk->used += size;
+
+    arena->last      = block;
+    arena->last_size = size;
+
+    arena->current += size;
+    if (arena->current > arena->peak)
+    {
+        arena->peak = arena->current;
+    }
+
+    return block;
+}
+
+void* ARENA_calloc(ARENA* arena, size_t num, size_t size)
+{
+    void* block = ARENA_alloc(arena, num * size);
+    memset(block, 0, num * size);
+
+    return block;
+}
+
+// Resize a block of the region.
+// The most recent allocation is extended in place if the chunk allows,
+// otherwise the contents are moved to a new block and the old one is abandoned.
+void* ARENA_realloc(ARENA* arena, void* block, size_t old_size, size_t new_size)
+{
+    if (block == NULL)
+    {
+        return ARENA_alloc(arena, new_size);
+    }
+
+    if (new_size <= old_size)
+    {
+        return block;
+    }
+
+    ARENA_CHUNK* chunk = arena->chunks;
+    if (block == arena->last)
+    {
+        size_t extension = ARENA_align(new_size) - arena->last_size;
+
+        if (chunk->capacity - chunk->used >= extension)
+        {
+            chunk->used     += extension;
+            arena->last_size += extension;
+
+            arena->current += extension;
+            if (arena->current > arena->peak)
+            {
+                arena->peak = arena->current;
+            }
+
+            return block;
+        }
+    }
+
+    void* new_block = ARENA_alloc(arena, new_size);
+    memcpy(new_block, block, old_size);
+
+    return new_block;
+}
+
+// Release every block of the region, but keep the memory for reuse.
+// NOTE: the chunks are merged into one, so that a similar workload fits in a single chunk.
+void ARENA_reset(ARENA* arena)
+{
+    if (arena->chunks != NULL && arena->chunks->next != NULL)
+    {
+        size_t reserved = arena->reserved;
+
+        while (arena->chunks != NULL)
+        {
+            ARENA_CHUNK* next = arena->chunks->next;
+            free(arena->chunks);
+            arena->chunks = next;
+        }
+
+        arena->reserved = 0U;
+        ARENA_grow(arena, reserved);
+    }
+
+    if (arena->chunks != NULL)
+    {
+        arena->chunks->used = 0U;
+    }
+
+    arena->last      = NULL;
+    arena->last_size = 0U;
+    arena->current   = 0U;
+}
+
+void ARENA_free(ARENA* arena)
+{
+    while (arena->chunks != NULL)
+    {
+        ARENA_CHUNK* next = arena->chunks->next;
+        free(arena->chunks);
+        arena->chunks = next;
+    }
+
+    arena->last      = NULL;
+    arena->last_size = 0U;
+    arena->current   = 0U;
+    arena->reserved  = 0U;
+}
+
+#endif // DPLL_ARENA_H
@@ -0,0 +1,220 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_BATCH_H
+#define DPLL_BATCH_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <threads.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "dimacs.h"
+#include "solver.h"
+
+//================//
+// List of inputs //
+//================//
+
+typedef char* path_t;
+
+bool PATH_eq(const path_t* el1, const path_t* el2)
+{
+    return strcmp(*el1, *el2) == 0;
+}
+
+bool PATH_lt(const path_t* el1, const path_t* el2)
+{
+    return strcmp(*el1, *el2) < 0;
+}
+
+// Parametrize stack with path data type:
+#define DATA_T         path_t
+#define DATA_STRUCTURE PATH_STORAGE
+#include "template_stack.h"
+
+void PATH_STORAGE_add(PATH_STORAGE* paths, const char* dir, const char* name)
+{
+    size_t dir_len  = (dir == NULL)? 0U : strlen(dir);
+    size_t name_len = strlen(name);
+
+    char* path = malloc(dir_len + name_len + 2U);
+    VERIFY_CONTRACT(path != NULL,
+        "[%s] Unable to allocate path %s\n", "PATH_STORAGE_add", name);
+
+    if (dir != NULL)
+    {
+        memcpy(path, dir, dir_len);
+        path[dir_len++] = '/';
+    }
+
+    memcpy(path + dir_len, name, name_len + 1U);
+
+    if (paths->sorted)
+    {
+        PATH_STORAGE_insert_sorted(paths, path);
+    }
+    else
+    {
+        PATH_STORAGE_push(paths, path);
+    }
+}
+
+// Add an input file or every *.cnf file of an input directory.
+void PATH_STORAGE_add_input(PATH_STORAGE* paths, const char* input)
+{
+    DIR* dir = opendir(input);
+    if (dir == NULL)
+    {
+        PATH_STORAGE_add(paths, NULL, input);
+        return;
+    }
+
+    // Keep directory listing in a deterministic order:
+    PATH_STORAGE listing;
+    PATH_STORAGE_init(&listing, PATH_eq, PATH_lt, true /*sorted*/);
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        size_t len = strlen(entry->d_name);
+        if (len > 4U && strcmp(entry->d_name + len - 4U, ".cnf") == 0)
+        {
+            PATH_STORAGE_add(&listing, input, entry->d_name);
+        }
+    }
+
+    closedir(dir);
+
+    for (size_t path_i = 0U; path_i < listing.size; ++path_i)
+    {
+        PATH_STORAGE_push(paths, PATH_STORAGE_get(&listing, path_i));
+    }
+
+    PATH_STORAGE_free(&listing);
+}
+
+void PATH_STORAGE_free_all(PATH_STORAGE* paths)
+{
+    for (size_t path_i = 0U; path_i < paths->size; ++path_i)
+    {
+        free(PATH_STORAGE_get(paths, path_i));
+    }
+
+    PATH_STORAGE_free(paths);
+}
+
+//====================//
+// Batch solving pool //
+//====================//
+
+typedef struct
+{
+    PATH_STORAGE paths;
+
+    // Next formula to be scheduled:
+    atomic_size_t next;
+
+    // Result accounting:
+    mtx_t  output_lock;
+    size_t num_sat;
+    size_t num_unsat;
+} BATCH;
+
+int batch_worker_main(void* arg)
+{
+    BATCH* batch = arg;
+
+    // Search state of every formula comes from the same region:
+    ARENA arena;
+    ARENA_init(&arena, 0U);
+
+    while (true)
+    {
+        size_t path_i = atomic_fetch_add(&batch->next, 1U);
+        if (path_i >= batch->paths.size)
+        {
+            break;
+        }
+
+        const char* path = PATH_STORAGE_get(&batch->paths, path_i);
+
+        double start = TIME_now();
+
+        FORMULA formula;
+        DIMACS_load_formula(path, &formula);
+
+        sat_t ret = dpll_solve(&formula, NULL, NULL, NULL, NULL, NULL, &arena, NULL);
+
+        FORMULA_free(&formula);
+
+        double elapsed = TIME_now() - start;
+
+        mtx_lock(&batch->output_lock);
+
+        printf("%s %s %.3f ms\n", path, ret == SAT? "SAT" : "UNSAT", 1e3 * elapsed);
+
+        batch->num_sat   += (ret == SAT);
+        batch->num_unsat += (ret == UNSAT);
+
+        mtx_unlock(&batch->output_lock);
+    }
+
+    ARENA_free(&arena);
+
+    return 0;
+}
+
+// Solve every input formula on a pool of threads.
+// NOTE: zero threads stand for the number of online processors.
+void dpll_solve_batch(const char** inputs, size_t num_inputs, size_t num_threads)
+{
+    if (num_threads == 0U)
+    {
+        long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = (num_cpus > 0)? (size_t) num_cpus : 1U;
+    }
+
+    BATCH batch;
+    PATH_STORAGE_init(&batch.paths, PATH_eq, PATH_lt, false /*sorted*/);
+
+    for (size_t input_i = 0U; input_i < num_inputs; ++input_i)
+    {
+        PATH_STORAGE_add_input(&batch.paths, inputs[input_i]);
+    }
+
+    atomic_init(&batch.next, 0U);
+    mtx_init(&batch.output_lock, mtx_plain);
+    batch.num_sat   = 0U;
+    batch.num_unsat = 0U;
+
+    double start = TIME_now();
+
+    thrd_t* threads = calloc(num_threads, sizeof(thrd_t));
+    VERIFY_CONTRACT(threads != NULL,
+        "[%s] Unable to allocate %zu threads\n", "dpll_solve_batch", num_threads);
+
+    for (size_t i = 0U; i < num_threads; ++i)
+    {
+        int ret = thrd_create(&threads[i], batch_worker_main, &batch);
+        VERIFY_CONTRACT(ret == thrd_success,
+            "[%s] Unable to start thread #%zu\n", "dpll_solve_batch", i);
+    }
+
+    for (size_t i = 0U; i < num_threads; ++i)
+    {
+        thrd_join(threads[i], NULL);
+    }
+
+    free(threads);
+
+    printf("c %zu formulas: %zu SAT, %zu UNSAT, %.3f s on %zu threads\n",
+        batch.paths.size, batch.num_sat, batch.num_unsat,
+        TIME_now() - start, num_threads);
+
+    mtx_destroy(&batch.output_lock);
+    PATH_STORAGE_free_all(&batch.paths);
+}
+
+#endif // DPLL_BATCH_H
@@ -0,0 +1,171 @@
+// No copyright. Vladislav Aleinik, 2023
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+
+//=================================//
+// Benchmark and regression driver //
+//=================================//
+
+void bench_usage(const char* program)
+{
+    printf("Usage: %s [options] (file.cnf | directory)...\n", program);
+    printf("       %s --compare BASELINE.csv CURRENT.csv [--cpu]\n", program);
+    printf("Options:\n");
+    printf("  --solver PATH       solver executable (default: ./dpll)\n");
+    printf("  --repeat N          run every formula N times (default: 3)\n");
+    printf("  --timeout S         kill the solver after S seconds\n");
+    printf("  --format csv|json   format of the results (default: csv)\n");
+    printf("  --output FILE       write the results to FILE instead of stdout\n");
+    printf("  --compare OLD NEW   flag significant differences between two CSV results\n");
+    printf("  --cpu               compare CPU time instead of wall time\n");
+
+    exit(EXIT_FAILURE);
+}
+
+const char* bench_read_argument(int argc, char* argv[], int* arg_i)
+{
+    if (*arg_i + 1 >= argc)
+    {
+        bench_usage(argv[0]);
+    }
+
+    *arg_i += 1;
+
+    return argv[*arg_i];
+}
+
+size_t bench_read_number(int argc, char* argv[], int* arg_i)
+{
+    const char* arg = bench_read_argument(argc, argv, arg_i);
+
+    char* endptr = NULL;
+    unsigned long long value = strtoull(arg, &endptr, 10);
+    if (endptr == arg || *endptr != '\0')
+    {
+        printf("Invalid numeric argument \"%s\"\n", arg);
+        bench_usage(argv[0]);
+    }
+
+    return value;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* solver  = "./dpll";
+    size_t      repeat  = 3U;
+    unsigned    timeout = 0U;
+    bool        json    = false;
+    const char* output  = NULL;
+
+    const char* baseline = NULL;
+    const char* current  = NULL;
+    bool cpu_time = false;
+
+    PATH_STORAGE instances;
+    PATH_STORAGE_init(&instances, PATH_eq, PATH_lt, false /*sorted*/);
+
+    for (int arg_i = 1; arg_i < argc; ++arg_i)
+    {
+        const char* arg = argv[arg_i];
+
+        if (strcmp(arg, "--solver") == 0)
+        {
+            solver = bench_read_argument(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--repeat") == 0)
+        {
+            repeat = bench_read_number(argc, argv, &arg_i);
+            if (repeat == 0U)
+            {
+                bench_usage(argv[0]);
+            }
+        }
+        else if (strcmp(arg, "--timeout") == 0)
+        {
+            timeout = bench_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--format") == 0)
+        {
+            const char* format = bench_read_argument(argc, argv, &arg_i);
+            if (strcmp(format, "json") == 0)
+            {
+                json = true;
+            }
+            else if (strcmp(format, "csv") != 0)
+            {
+                bench_usage(argv[0]);
+            }
+        }
+        else if (strcmp(arg, "--output") == 0)
+        {
+            output = bench_read_argument(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--compare") == 0)
+        {
+            baseline = bench_read_argument(argc, argv, &arg_i);
+            current  = bench_read_argument(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--cpu") == 0)
+        {
+            cpu_time = true;
+        }
+        else if (arg[0] == '-')
+        {
+            bench_usage(argv[0]);
+        }
+        else
+        {
+            PATH_STORAGE_add_input(&instances, arg);
+        }
+    }
+
+    // Regression comparison mode:
+    if (baseline != NULL)
+    {
+        PATH_STORAGE_free_all(&instances);
+
+        size_t num_slower = bench_compare(baseline, current, cpu_time);
+
+        return (num_slower == 0U)? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (instances.size == 0U)
+    {
+        bench_usage(argv[0]);
+    }
+
+    FILE* file = stdout;
+    if (output != NULL)
+    {
+        file = fopen(output, "w");
+        VERIFY_CONTRACT(file != NULL,
+            "[%s] Unable to open output file %s\n", "bench", output);
+    }
+
+    // Report progress only if it does not mix with the results:
+    BENCH_STORAGE records;
+    size_t num_errors = bench_run(solver, &instances, repeat, timeout, output != NULL, &records);
+
+    if (json)
+    {
+        bench_write_json(file, &records);
+    }
+    else
+    {
+        bench_write_csv(file, &records);
+    }
+
+    if (output != NULL)
+    {
+        fclose(file);
+    }
+
+    BENCH_STORAGE_free(&records);
+    PATH_STORAGE_free_all(&instances);
+
+    return (num_errors == 0U)? EXIT_SUCCESS : EXIT_FAILURE;
+}
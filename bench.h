@@ -0,0 +1,487 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_BENCH_H
+#define DPLL_BENCH_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "batch.h"
+
+//===================//
+// Benchmark records //
+//===================//
+
+// Measurement of a single solver run:
+typedef struct
+{
+    const char* instance;
+    size_t run;
+
+    // SAT, UNSAT, UNKNOWN, TIMEOUT or ERROR:
+    const char* result;
+
+    // Resource usage of the solver process:
+    double wall_ms;
+    double cpu_ms;
+    long   max_rss_kb;
+
+    // Search statistics reported by the solver:
+    STATS stats;
+} BENCH_RECORD;
+
+bool BENCH_RECORD_eq(const BENCH_RECORD* el1, const BENCH_RECORD* el2)
+{
+    return el1->instance == el2->instance && el1->run == el2->run;
+}
+
+bool BENCH_RECORD_lt(const BENCH_RECORD* el1, const BENCH_RECORD* el2)
+{
+    return el1->wall_ms < el2->wall_ms;
+}
+
+// Parametrize stack with benchmark record data type:
+#define DATA_T         BENCH_RECORD
+#define DATA_STRUCTURE BENCH_STORAGE
+#include "template_stack.h"
+
+//=================//
+// Solver launcher //
+//=================//
+
+// Exit code of the solver reporting the result (as in SAT competitions).
+int bench_exit_code(const char* result)
+{
+    if (strcmp(result, "SAT") == 0)
+    {
+        return 10;
+    }
+
+    if (strcmp(result, "UNSAT") == 0)
+    {
+        return 20;
+    }
+
+    return 0;
+}
+
+// Run the solver on a single formula in a child process.
+// NOTE: zero timeout stands for no time limit.
+void bench_run_one(const char* solver, const char* instance, unsigned timeout, BENCH_RECORD* record)
+{
+    record->instance   = instance;
+    record->result     = "ERROR";
+    record->wall_ms    = 0.0;
+    record->cpu_ms     = 0.0;
+    record->max_rss_kb = 0L;
+
+    STATS_init(&record->stats);
+
+    int fds[2];
+    int ret = pipe(fds);
+    VERIFY_CONTRACT(ret == 0,
+        "[%s] Unable to create pipe\n", "bench_run_one");
+
+    double start = TIME_now();
+
+    pid_t pid = fork();
+    VERIFY_CONTRACT(pid != -1,
+        "[%s] Unable to fork solver process\n", "bench_run_one");
+
+    if (pid == 0)
+    {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+
+        // Pending alarm survives the exec and kills the solver on timeout:
+        if (timeout != 0U)
+        {
+            alarm(timeout);
+        }
+
+        execl(solver, solver, "--stats", instance, (char*) NULL);
+        _exit(127);
+    }
+
+    close(fds[1]);
+
+    // Parse the solver output:
+    FILE* output = fdopen(fds[0], "r");
+    VERIFY_CONTRACT(output != NULL,
+        "[%s] Unable to read solver output\n", "bench_run_one");
+
+    const char* result = NULL;
+
+    char line[256];
+    while (fgets(line, sizeof(line), output) != NULL)
+    {
+        if (strcmp(line, "SAT\n") == 0)
+        {
+            result = "SAT";
+        }
+        else if (strcmp(line, "UNSAT\n") == 0)
+        {
+            result = "UNSAT";
+        }
+        else if (strcmp(line, "UNKNOWN\n") == 0)
+        {
+            result = "UNKNOWN";
+        }
+        else
+        {
+            sscanf(line, "c decisions %"SCNu64" propagations %"SCNu64" conflicts %"SCNu64,
+                &record->stats.decisions, &record->stats.propagations, &record->stats.conflicts);
+        }
+    }
+
+    fclose(output);
+
+    int status;
+    struct rusage usage;
+    pid_t waited = wait4(pid, &status, 0, &usage);
+    VERIFY_CONTRACT(waited == pid,
+        "[%s] Unable to wait for solver process\n", "bench_run_one");
+
+    record->wall_ms = 1e3 * (TIME_now() - start);
+
+    record->cpu_ms = 1e3 * (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+                     1e-3 * (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+
+    // NOTE: Linux reports the maximum resident set size in kilobytes.
+    record->max_rss_kb = usage.ru_maxrss;
+
+    if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM)
+    {
+        record->result = "TIMEOUT";
+    }
+    else if (WIFEXITED(status) && result != NULL && WEXITSTATUS(status) == bench_exit_code(result))
+    {
+        record->result = result;
+    }
+}
+
+//================//
+// Result writers //
+//================//
+
+#define BENCH_CSV_HEADER \
+    "instance,run,result,wall_ms,cpu_ms,max_rss_kb,decisions,propagations,conflicts\n"
+
+void bench_write_csv(FILE* file, const BENCH_STORAGE* records)
+{
+    fprintf(file, BENCH_CSV_HEADER);
+
+    for (size_t rec_i = 0U; rec_i < records->size; ++rec_i)
+    {
+        const BENCH_RECORD* rec = BENCH_STORAGE_get_ptr(records, rec_i);
+
+        fprintf(file, "%s,%zu,%s,%.3f,%.3f,%ld,%"PRIu64",%"PRIu64",%"PRIu64"\n",
+            rec->instance, rec->run, rec->result,
+            rec->wall_ms, rec->cpu_ms, rec->max_rss_kb,
+            rec->stats.decisions, rec->stats.propagations, rec->stats.conflicts);
+    }
+}
+
+void bench_write_json(FILE* file, const BENCH_STORAGE* records)
+{
+    fprintf(file, "[\n");
+
+    for (size_t rec_i = 0U; rec_i < records->size; ++rec_i)
+    {
+        const BENCH_RECORD* rec = BENCH_STORAGE_get_ptr(records, rec_i);
+
+        fprintf(file, "  {\"instance\": \"");
+        for (const char* c = rec->instance; *c != '\0'; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                fputc('\\', file);
+            }
+
+            fputc(*c, file);
+        }
+
+        fprintf(file, "\", \"run\": %zu, \"result\": \"%s\", "
+            "\"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"max_rss_kb\": %ld, "
+            "\"decisions\": %"PRIu64", \"propagations\": %"PRIu64", \"conflicts\": %"PRIu64"}%s\n",
+            rec->run, rec->result,
+            rec->wall_ms, rec->cpu_ms, rec->max_rss_kb,
+            rec->stats.decisions, rec->stats.propagations, rec->stats.conflicts,
+            (rec_i + 1U == records->size)? "" : ",");
+    }
+
+    fprintf(file, "]\n");
+}
+
+//
+// Benchmark driver
+//
+
+// Run the solver on every input formula the given number of times.
+// NOTE: the runs are interleaved to spread the machine noise over the instances.
+// Return the number of failed runs.
+size_t bench_run(const char* solver, const PATH_STORAGE* instances,
+               size_t repeat, unsigned timeout, bool verbose, BENCH_STORAGE* records)
+{
+    BENCH_STORAGE_init(records, BENCH_RECORD_eq, BENCH_RECORD_lt, false /*sorted*/);
+
+    size_t num_errors = 0U;
+    for (size_t run = 0U; run < repeat; ++run)
+    {
+        for (size_t path_i = 0U; path_i < instances->size; ++path_i)
+        {
+            BENCH_RECORD record;
+            bench_run_one(solver, PATH_STORAGE_get(instances, path_i), timeout, &record);
+            record.run = run;
+
+            if (verbose)
+            {
+                printf("%s #%zu %s %.3f ms\n",
+                    record.instance, run, record.result, record.wall_ms);
+            }
+
+            if (strcmp(record.result, "ERROR") == 0)
+            {
+                num_errors += 1U;
+            }
+
+            BENCH_STORAGE_push(records, record);
+        }
+    }
+
+    return num_errors;
+}
+
+//=======================//
+// Regression comparison //
+//=======================//
+
+// Running statistics of an instance measurements:
+typedef struct
+{
+    char*  instance;
+    size_t num_samples;
+    double mean;
+    double m2;
+} BENCH_SERIES;
+
+bool BENCH_SERIES_eq(const BENCH_SERIES* el1, const BENCH_SERIES* el2)
+{
+    return strcmp(el1->instance, el2->instance) == 0;
+}
+
+bool BENCH_SERIES_lt(const BENCH_SERIES* el1, const BENCH_SERIES* el2)
+{
+    return strcmp(el1->instance, el2->instance) < 0;
+}
+
+// Parametrize stack with measurement series data type:
+#define DATA_T         BENCH_SERIES
+#define DATA_STRUCTURE SERIES_STORAGE
+#include "template_stack.h"
+
+double BENCH_SERIES_variance(const BENCH_SERIES* series)
+{
+    return (series->num_samples < 2U)? 0.0 : series->m2 / (series->num_samples - 1U);
+}
+
+// Add a sample to the series of the instance (Welford's algorithm).
+void SERIES_STORAGE_add_sample(SERIES_STORAGE* all_series, const char* instance, double sample)
+{
+    BENCH_SERIES key = {.instance = (char*) instance};
+
+    size_t index = SERIES_STORAGE_search_sorted(all_series, key);
+    if (index == all_series->size ||
+        !BENCH_SERIES_eq(SERIES_STORAGE_get_ptr(all_series, index), &key))
+    {
+        key.instance = strdup(instance);
+        VERIFY_CONTRACT(key.instance != NULL,
+            "[%s] Unable to allocate instance name\n", "SERIES_STORAGE_add_sample");
+
+        key.num_samples = 0U;
+        key.mean        = 0.0;
+        key.m2          = 0.0;
+
+        SERIES_STORAGE_insert(all_series, key, index);
+    }
+
+    BENCH_SERIES* series = SERIES_STORAGE_get_ptr(all_series, index);
+
+    series->num_samples += 1U;
+
+    double delta = sample - series->mean;
+    series->mean += delta / series->num_samples;
+    series->m2   += delta * (sample - series->mean);
+}
+
+void SERIES_STORAGE_free_all(SERIES_STORAGE* all_series)
+{
+    for (size_t series_i = 0U; series_i < all_series->size; ++series_i)
+    {
+        free(SERIES_STORAGE_get_ptr(all_series, series_i)->instance);
+    }
+
+    SERIES_STORAGE_free(all_series);
+}
+
+// Read the chosen time metric of the solved runs from a CSV file.
+void bench_read_csv(const char* filename, bool cpu_time, SERIES_STORAGE* all_series)
+{
+    SERIES_STORAGE_init(all_series, BENCH_SERIES_eq, BENCH_SERIES_lt, true /*sorted*/);
+
+    FILE* file = fopen(filename, "r");
+    VERIFY_CONTRACT(file != NULL,
+        "[%s] Unable to open benchmark results %s\n", "bench_read_csv", filename);
+
+    char line[4096];
+    char* header = fgets(line, sizeof(line), file);
+    VERIFY_CONTRACT(header != NULL && strcmp(header, BENCH_CSV_HEADER) == 0,
+        "[%s] File %s is not a benchmark CSV\n", "bench_read_csv", filename);
+
+    size_t line_i = 1U;
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        line_i += 1U;
+
+        char instance[4096];
+        char result[16];
+        size_t run;
+        double wall_ms, cpu_ms;
+
+        int ret = sscanf(line, "%4095[^,],%zu,%15[^,],%lf,%lf,",
+            instance, &run, result, &wall_ms, &cpu_ms);
+        VERIFY_CONTRACT(ret == 5,
+            "[%s] Invalid record at %s:%zu\n", "bench_read_csv", filename, line_i);
+
+        // Timeouts and errors do not measure the solver speed:
+        if (strcmp(result, "SAT") == 0 || strcmp(result, "UNSAT") == 0)
+        {
+            SERIES_STORAGE_add_sample(all_series, instance, cpu_time? cpu_ms : wall_ms);
+        }
+    }
+
+    fclose(file);
+}
+
+// Two-sided critical values of Student's t-distribution for p = 0.05:
+double bench_t_critical(double dof)
+{
+    static const double table[] =
+    {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+         2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+         2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+
+    size_t table_size = sizeof(table) / sizeof(table[0U]);
+
+    // Fractional degrees of freedom are rounded down to stay conservative:
+    if (dof < 1.0)
+    {
+        return table[0U];
+    }
+
+    if (dof >= table_size + 1U)
+    {
+        return 1.960;
+    }
+
+    return table[(size_t) dof - 1U];
+}
+
+// Compare the measurements of two builds with Welch's t-test.
+//
+// Return the number of significantly slower instances.
+size_t bench_compare(const char* baseline_file, const char* current_file, bool cpu_time)
+{
+    SERIES_STORAGE baseline, current;
+    bench_read_csv(baseline_file, cpu_time, &baseline);
+    bench_read_csv(current_file,  cpu_time, &current);
+
+    size_t num_compared = 0U;
+    size_t num_slower   = 0U;
+    size_t num_faster   = 0U;
+
+    double log_ratio_sum = 0.0;
+
+    for (size_t series_i = 0U; series_i < current.size; ++series_i)
+    {
+        const BENCH_SERIES* cur = SERIES_STORAGE_get_ptr(&current, series_i);
+
+        size_t index = SERIES_STORAGE_search_sorted(&baseline, *cur);
+        if (index == baseline.size ||
+            !BENCH_SERIES_eq(SERIES_STORAGE_get_ptr(&baseline, index), cur))
+        {
+            continue;
+        }
+
+        const BENCH_SERIES* base = SERIES_STORAGE_get_ptr(&baseline, index);
+
+        num_compared  += 1U;
+        log_ratio_sum += log(cur->mean / base->mean);
+
+        // Significance is not testable without repeated measurements:
+        if (base->num_samples < 2U || cur->num_samples < 2U)
+        {
+            continue;
+        }
+
+        double var_base = BENCH_SERIES_variance(base) / base->num_samples;
+        double var_cur  = BENCH_SERIES_variance(cur)  / cur->num_samples;
+
+        double diff = cur->mean - base->mean;
+
+        bool significant;
+        double t_value = 0.0;
+        if (var_base + var_cur == 0.0)
+        {
+            significant = diff != 0.0;
+        }
+        else
+        {
+            t_value = diff / sqrt(var_base + var_cur);
+
+            // Welch-Satterthwaite approximation of the degrees of freedom:
+            double dof = (var_base + var_cur) * (var_base + var_cur) /
+                (var_base * var_base / (base->num_samples - 1U) +
+                 var_cur  * var_cur  / (cur->num_samples  - 1U));
+
+            significant = fabs(t_value) > bench_t_critical(dof);
+        }
+
+        if (!significant)
+        {
+            continue;
+        }
+
+        if (diff > 0.0)
+        {
+            num_slower += 1U;
+        }
+        else
+        {
+            num_faster += 1U;
+        }
+
+        printf("%s %s %.3f ms -> %.3f ms (x%.3f, t = %.2f)\n",
+            (diff > 0.0)? "SLOWER" : "FASTER", cur->instance,
+            base->mean, cur->mean, cur->mean / base->mean, t_value);
+    }
+
+    printf("c %zu instances compared: %zu slower, %zu faster, geometric mean ratio %.3f\n",
+        num_compared, num_slower, num_faster,
+        (num_compared == 0U)? 1.0 : exp(log_ratio_sum / num_compared));
+
+    SERIES_STORAGE_free_all(&baseline);
+    SERIES_STORAGE_free_all(&current);
+
+    return num_slower;
+}
+
+#endif // DPLL_BENCH_H
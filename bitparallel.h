@@ -0,0 +1,274 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_BITPARALLEL_H
+#define DPLL_BITPARALLEL_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "utils.h"
+#include "formula.h"
+#include "rng.h"
+
+//=====================================//
+// Bit-parallel evaluation of formulas //
+//=====================================//
+
+// Every bit of a machine word is a lane holding a separate assignment.
+// The value of a literal in all the lanes is a vector of words,
+// a clause is evaluated for all the lanes by OR-ing the vectors of its literals.
+// Falsified clauses are counted per lane by bit-sliced counters:
+// plane p holds bit p of every lane's counter.
+
+// Largest vector (measured in 64-bit words) and the number of counter planes:
+#define BITPARALLEL_MAX_WORDS  8U
+#define BITPARALLEL_NUM_PLANES 32U
+
+#define BITPARALLEL_ALIGNMENT 64U
+
+typedef void (*bitparallel_kernel_t)(const uint32_t* literals, const uint32_t* end,
+                                     const uint64_t* values, uint64_t* planes);
+
+typedef struct
+{
+    size_t num_variables;
+    size_t num_clauses;
+
+    // Clause literals as 2*var + sign, every clause is terminated by zero:
+    uint32_t* literals;
+    size_t    num_literals;
+
+    // Words in a vector of lanes:
+    unsigned num_words;
+
+    // Lanes of every literal (negative literals hold the complement):
+    uint64_t* values;
+
+    // Per-lane counters of the falsified clauses:
+    uint64_t* planes;
+
+    bitparallel_kernel_t kernel;
+} BITPARALLEL;
+
+//
+// Evaluation kernels
+//
+
+// Kernel for vectors of the given type.
+// The carry of the counter increment is propagated only while some lane still carries.
+#define BITPARALLEL_KERNEL(name, vector_t, attributes)                                      \
+attributes void name(const uint32_t* literals, const uint32_t* end,                         \
+                     const uint64_t* values, uint64_t* planes)                              \
+{                                                                                           \
+    const unsigned num_words = sizeof(vector_t) / sizeof(uint64_t);                         \
+                                                                                            \
+    const vector_t* lanes   = (const vector_t*) values;                                     \
+    vector_t*       counter = (vector_t*) planes;                                           \
+                                                                                            \
+    vector_t satisfied = {0U};                                                              \
+    for (const uint32_t* lit = literals; lit != end; ++lit)                                 \
+    {                                                                                       \
+        if (*lit != 0U)                                                                     \
+        {                                                                                   \
+            satisfied |= lanes[*lit];                                                       \
+            continue;                                                                       \
+        }                                                                                   \
+                                                                                            \
+        vector_t carry = ~satisfied;                                                        \
+        for (unsigned plane = 0U; plane < BITPARALLEL_NUM_PLANES; ++plane)                  \
+        {                                                                                   \
+            uint64_t carries = 0U;                                                          \
+            for (unsigned word = 0U; word < num_words; ++word)                              \
+            {                                                                               \
+                carries |= ((const uint64_t*) &carry)[word];                                \
+            }                                                                               \
+                                                                                            \
+            if (carries == 0U)                                                              \
+            {                                                                               \
+                break;                                                                      \
+            }                                                                               \
+                                                                                            \
+            vector_t next   = counter[plane] & carry;                                       \
+            counter[plane] ^= carry;                                                        \
+            carry           = next;                                                         \
+        }                                                                                   \
+                                                                                            \
+        satisfied = (vector_t) {0U};                                                        \
+    }                                                                                       \
+}
+
+typedef uint64_t bitparallel_64_t;
+BITPARALLEL_KERNEL(BITPARALLEL_kernel_64, bitparallel_64_t, )
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+typedef uint64_t bitparallel_256_t __attribute__((vector_size(32)));
+typedef uint64_t bitparallel_512_t __attribute__((vector_size(64)));
+
+BITPARALLEL_KERNEL(BITPARALLEL_kernel_256, bitparallel_256_t, __attribute__((target("avx2"))))
+BITPARALLEL_KERNEL(BITPARALLEL_kernel_512, bitparallel_512_t, __attribute__((target("avx512f"))))
+#endif
+
+// Widest vector supported by the processor (measured in 64-bit words).
+unsigned BITPARALLEL_widest(void)
+{
+    #if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return 8U;
+    }
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return 4U;
+    }
+    #endif
+
+    return 1U;
+}
+
+//
+// Evaluation state
+//
+
+// Lay out the formula for the evaluation.
+// The vector width is limited by max_words (zero for the widest one supported).
+void BITPARALLEL_init(BITPARALLEL* bp, const FORMULA* formula, unsigned max_words)
+{
+    bp->num_variables = VARIABLES_max_value(&formula->variables);
+    bp->num_clauses   = FORMULA_size(formula);
+
+    bp->num_words = BITPARALLEL_widest();
+    if (max_words != 0U && max_words < bp->num_words)
+    {
+        bp->num_words = (max_words >= 4U)? 4U : 1U;
+    }
+
+    bp->kernel = BITPARALLEL_kernel_64;
+    #if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    if (bp->num_words == 8U)
+    {
+        bp->kernel = BITPARALLEL_kernel_512;
+    }
+    else if (bp->num_words == 4U)
+    {
+        bp->kernel = BITPARALLEL_kernel_256;
+    }
+    #endif
+
+    bp->num_literals = 0U;
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        bp->num_literals += CLAUSE_size(FORMULA_get(formula, cls_i)) + 1U;
+    }
+
+    bp->literals = malloc(bp->num_literals * sizeof(uint32_t) + 1U);
+
+    // Aligned allocations have to be multiples of the alignment:
+    size_t values_size = 2U * (bp->num_variables + 1U) * bp->num_words * sizeof(uint64_t);
+    size_t planes_size = BITPARALLEL_NUM_PLANES * bp->num_words * sizeof(uint64_t);
+
+    bp->values = aligned_alloc(BITPARALLEL_ALIGNMENT,
+        (values_size + BITPARALLEL_ALIGNMENT - 1U) & ~(BITPARALLEL_ALIGNMENT - 1U));
+    bp->planes = aligned_alloc(BITPARALLEL_ALIGNMENT,
+        (planes_size + BITPARALLEL_ALIGNMENT - 1U) & ~(BITPARALLEL_ALIGNMENT - 1U));
+    VERIFY_CONTRACT(bp->literals != NULL && bp->values != NULL && bp->planes != NULL,
+        "[%s] Unable to allocate evaluation state of %zu literals\n", "BITPARALLEL_init", bp->num_literals);
+
+    uint32_t* out = bp->literals;
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            literal_t lit = CLAUSE_get(cls, lit_i);
+
+            *out++ = 2U * LITERAL_VALUE_Get(lit) + ((lit & LITERAL_CONTRARY_BIT) != 0U);
+        }
+
+        *out++ = 0U;
+    }
+
+    // Every variable is false in every lane:
+    for (size_t var = 0U; var <= bp->num_variables; ++var)
+    {
+        for (unsigned word = 0U; word < bp->num_words; ++word)
+        {
+            bp->values[(2U * var)      * bp->num_words + word] = 0U;
+            bp->values[(2U * var + 1U) * bp->num_words + word] = ~(uint64_t) 0U;
+        }
+    }
+}
+
+void BITPARALLEL_free(BITPARALLEL* bp)
+{
+    free(bp->literals);
+    free(bp->values);
+    free(bp->planes);
+}
+
+size_t BITPARALLEL_num_lanes(const BITPARALLEL* bp)
+{
+    return 64U * bp->num_words;
+}
+
+void BITPARALLEL_set(BITPARALLEL* bp, size_t var, size_t lane, bool value)
+{
+    uint64_t* positive = &bp->values[(2U * var)      * bp->num_words + lane / 64U];
+    uint64_t* negative = &bp->values[(2U * var + 1U) * bp->num_words + lane / 64U];
+
+    uint64_t bit = (uint64_t) 1U << (lane % 64U);
+
+    *positive = value? (*positive | bit) : (*positive & ~bit);
+    *negative = value? (*negative & ~bit) : (*negative | bit);
+}
+
+bool BITPARALLEL_get(const BITPARALLEL* bp, size_t var, size_t lane)
+{
+    return (bp->values[2U * var * bp->num_words + lane / 64U] >> (lane % 64U)) & 1U;
+}
+
+// Set every variable of every lane to the given word pattern.
+void BITPARALLEL_set_word(BITPARALLEL* bp, size_t var, unsigned word, uint64_t lanes)
+{
+    bp->values[(2U * var)      * bp->num_words + word] =  lanes;
+    bp->values[(2U * var + 1U) * bp->num_words + word] = ~lanes;
+}
+
+// Fill every lane with a random assignment.
+void BITPARALLEL_randomize(BITPARALLEL* bp, RNG* rng)
+{
+    for (size_t var = 1U; var <= bp->num_variables; ++var)
+    {
+        for (unsigned word = 0U; word < bp->num_words; ++word)
+        {
+            BITPARALLEL_set_word(bp, var, word, RNG_next(rng));
+        }
+    }
+}
+
+// Count the falsified clauses of every lane.
+// The unsat array holds a counter for every lane.
+void BITPARALLEL_evaluate(BITPARALLEL* bp, uint32_t* unsat)
+{
+    memset(bp->planes, 0, BITPARALLEL_NUM_PLANES * bp->num_words * sizeof(uint64_t));
+
+    bp->kernel(bp->literals, bp->literals + bp->num_literals, bp->values, bp->planes);
+
+    for (size_t lane = 0U; lane < BITPARALLEL_num_lanes(bp); ++lane)
+    {
+        uint32_t count = 0U;
+        for (unsigned plane = 0U; plane < BITPARALLEL_NUM_PLANES; ++plane)
+        {
+            uint64_t word = bp->planes[plane * bp->num_words + lane / 64U];
+            count |= (uint32_t) ((word >> (lane % 64U)) & 1U) << plane;
+        }
+
+        unsat[lane] = count;
+    }
+}
+
+#endif // DPLL_BITPARALLEL_H
@@ -0,0 +1,354 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_CARDINALITY_H
+#define DPLL_CARDINALITY_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "formula.h"
+
+//=======================================//
+// Counter-based cardinality propagation //
+//=======================================//
+
+// Every literal indexes the constraints it occurs in (the decision bit is dropped):
+#define CARDINALITY_NUM_INDICES (LITERAL_CONTRARY_BIT + NUM_LITERALS)
+
+// Every constraint counts its true literals.
+// The constraint that reaches its bound falsifies the rest of its literals,
+// the constraint that exceeds its bound is a conflict.
+typedef struct
+{
+    size_t num_constraints;
+
+    // Literals of constraint c are literals[start[c]..start[c + 1]):
+    literal_t* literals;
+    uint32_t*  start;
+    uint32_t*  bounds;
+
+    // True literals of every constraint:
+    uint32_t* num_true;
+
+    // Constraints of every literal are occurs[occurs_start[lit]..occurs_start[lit + 1]):
+    uint32_t* occurs_start;
+    uint32_t* occurs;
+} CARDINALITY_SYSTEM;
+
+// Lay out the cardinality constraints of the formula.
+// The system comes from the region.
+void CARDINALITY_SYSTEM_init(CARDINALITY_SYSTEM* cs, const FORMULA* formula, ARENA* arena)
+{
+    cs->num_constraints = FORMULA_num_cardinalities(formula);
+
+    size_t num_literals = 0U;
+    for (size_t card_i = 0U; card_i < cs->num_constraints; ++card_i)
+    {
+        num_literals += CARDINALITY_size(FORMULA_get_cardinality(formula, card_i));
+    }
+
+    cs->literals     = ARENA_calloc(arena, num_literals + 1U, sizeof(literal_t));
+    cs->start        = ARENA_calloc(arena, cs->num_constraints + 1U, sizeof(uint32_t));
+    cs->bounds       = ARENA_calloc(arena, cs->num_constraints, sizeof(uint32_t));
+    cs->num_true     = ARENA_calloc(arena, cs->num_constraints, sizeof(uint32_t));
+    cs->occurs_start = ARENA_calloc(arena, CARDINALITY_NUM_INDICES + 1U, sizeof(uint32_t));
+    cs->occurs       = ARENA_calloc(arena, num_literals + 1U, sizeof(uint32_t));
+    VERIFY_CONTRACT(cs->literals != NULL && cs->start != NULL && cs->bounds != NULL &&
+                    cs->num_true != NULL && cs->occurs_start != NULL && cs->occurs != NULL,
+        "[%s] Unable to allocate %zu cardinality constraints\n", "CARDINALITY_SYSTEM_init", cs->num_constraints);
+
+    size_t lit_out = 0U;
+    for (size_t card_i = 0U; card_i < cs->num_constraints; ++card_i)
+    {
+        const CARDINALITY* card = FORMULA_get_cardinality(formula, card_i);
+
+        cs->start[card_i]  = lit_out;
+        cs->bounds[card_i] = card->bound;
+
+        for (size_t lit_i = 0U; lit_i < CARDINALITY_size(card); ++lit_i)
+        {
+            literal_t lit = CARDINALITY_get(card, lit_i) & ~LITERAL_DECISION_BIT;
+
+            cs->literals[lit_out++] = lit;
+            cs->occurs_start[lit] += 1U;
+        }
+    }
+
+    cs->start[cs->num_constraints] = lit_out;
+
+    // Every start holds the end of its list, which moves to the beginning as the list is filled:
+    for (size_t index = 1U; index <= CARDINALITY_NUM_INDICES; ++index)
+    {
+        cs->occurs_start[index] += cs->occurs_start[index - 1U];
+    }
+
+    for (size_t card_i = cs->num_constraints; card_i-- > 0U;)
+    {
+        for (size_t lit_i = cs->start[card_i]; lit_i < cs->start[card_i + 1U]; ++lit_i)
+        {
+            cs->occurs[--cs->occurs_start[cs->literals[lit_i]]] = card_i;
+        }
+    }
+}
+
+void CARDINALITY_SYSTEM_assign(CARDINALITY_SYSTEM* cs, literal_t lit)
+{
+    lit &= ~LITERAL_DECISION_BIT;
+
+    for (uint32_t occ_i = cs->occurs_start[lit]; occ_i < cs->occurs_start[lit + 1U]; ++occ_i)
+    {
+        cs->num_true[cs->occurs[occ_i]] += 1U;
+    }
+}
+
+void CARDINALITY_SYSTEM_unassign(CARDINALITY_SYSTEM* cs, literal_t lit)
+{
+    lit &= ~LITERAL_DECISION_BIT;
+
+    for (uint32_t occ_i = cs->occurs_start[lit]; occ_i < cs->occurs_start[lit + 1U]; ++occ_i)
+    {
+        cs->num_true[cs->occurs[occ_i]] -= 1U;
+    }
+}
+
+//=============================================//
+// Detection of pairwise at-most-one encodings //
+//=============================================//
+
+// Binary clause (x | y) forbids the literals ~x and ~y to be true together,
+// so the binary clauses are the edges of a graph over the literals.
+// Every clique of the graph is an at-most-one constraint,
+// the clique of n literals replaces its n*(n-1)/2 clauses.
+#define CARDINALITY_MIN_GROUP 3U
+
+// Graph node of the literal: 2*var + sign.
+size_t CARDINALITY_node(literal_t lit)
+{
+    return 2U * LITERAL_VALUE_Get(lit) + ((lit & LITERAL_CONTRARY_BIT) != 0U);
+}
+
+literal_t CARDINALITY_node_literal(size_t node)
+{
+    literal_t lit = (node & 1U)? LITERAL_CONTRARY_BIT : 0U;
+    LITERAL_VALUE_Set(lit, node / 2U);
+
+    return lit;
+}
+
+// Candidate member of a clique:
+typedef struct
+{
+    uint32_t node;
+    uint32_t degree;
+} CARDINALITY_CANDIDATE;
+
+int CARDINALITY_CANDIDATE_cmp(const void* el1, const void* el2)
+{
+    const CARDINALITY_CANDIDATE* cand1 = el1;
+    const CARDINALITY_CANDIDATE* cand2 = el2;
+
+    // Larger degree first, smaller node on ties:
+    if (cand1->degree != cand2->degree)
+    {
+        return (cand1->degree > cand2->degree)? -1 : 1;
+    }
+
+    return (cand1->node < cand2->node)? -1 : (cand1->node > cand2->node);
+}
+
+// Greedily cover the graph of the binary clauses with cliques,
+// copy the formula with the covered clauses replaced by at-most-one constraints.
+//
+// Return the number of the constraints added.
+size_t CARDINALITY_detect_at_most_one(const FORMULA* formula, FORMULA* result)
+{
+    size_t num_nodes = 2U * (VARIABLES_max_value(&formula->variables) + 1U);
+    size_t num_words = num_nodes / 64U + 1U;
+
+    // Graph of the binary clauses and its edges that are not covered yet:
+    uint64_t* edges     = calloc(num_nodes * num_words, sizeof(uint64_t));
+    uint64_t* remaining = calloc(num_nodes * num_words, sizeof(uint64_t));
+    uint32_t* degrees   = calloc(num_nodes, sizeof(uint32_t));
+    uint64_t* common    = calloc(num_words, sizeof(uint64_t));
+    uint32_t* clique    = calloc(num_nodes, sizeof(uint32_t));
+    bool*     exhausted = calloc(num_nodes, sizeof(bool));
+    CARDINALITY_CANDIDATE* candidates = calloc(num_nodes, sizeof(CARDINALITY_CANDIDATE));
+    VERIFY_CONTRACT(edges != NULL && remaining != NULL && degrees != NULL &&
+                    common != NULL && clique != NULL && exhausted != NULL && candidates != NULL,
+        "[%s] Unable to allocate graph of %zu literals\n", "CARDINALITY_detect_at_most_one", num_nodes);
+
+    #define CARDINALITY_EDGE(matrix, node1, node2) \
+        (((matrix)[(node1) * num_words + (node2) / 64U] >> ((node2) % 64U)) & 1U)
+    #define CARDINALITY_FLIP(matrix, node1, node2) \
+        ((matrix)[(node1) * num_words + (node2) / 64U] ^= (uint64_t) 1U << ((node2) % 64U))
+
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+        if (CLAUSE_size(cls) != 2U ||
+            LITERAL_VALUE_Get(CLAUSE_get(cls, 0U)) == LITERAL_VALUE_Get(CLAUSE_get(cls, 1U)))
+        {
+            continue;
+        }
+
+        size_t node1 = CARDINALITY_node(CLAUSE_get(cls, 0U) ^ LITERAL_CONTRARY_BIT);
+        size_t node2 = CARDINALITY_node(CLAUSE_get(cls, 1U) ^ LITERAL_CONTRARY_BIT);
+
+        if (!CARDINALITY_EDGE(edges, node1, node2))
+        {
+            CARDINALITY_FLIP(edges, node1, node2);
+            CARDINALITY_FLIP(edges, node2, node1);
+            CARDINALITY_FLIP(remaining, node1, node2);
+            CARDINALITY_FLIP(remaining, node2, node1);
+
+            degrees[node1] += 1U;
+            degrees[node2] += 1U;
+        }
+    }
+
+    FORMULA_init(result);
+
+    for (size_t card_i = 0U; card_i < FORMULA_num_cardinalities(formula); ++card_i)
+    {
+        const CARDINALITY* card = FORMULA_get_cardinality(formula, card_i);
+
+        CARDINALITY copy;
+        CARDINALITY_init(&copy, card->bound);
+
+        for (size_t lit_i = 0U; lit_i < CARDINALITY_size(card); ++lit_i)
+        {
+            CARDINALITY_insert(&copy, CARDINALITY_get(card, lit_i));
+        }
+
+        FORMULA_insert_cardinality(result, copy);
+    }
+
+    // Every clique grows from the node of the largest remaining degree:
+    size_t num_groups = 0U;
+    while (true)
+    {
+        size_t seed = 0U;
+        for (size_t node = 1U; node < num_nodes; ++node)
+        {
+            if (!exhausted[node] && degrees[node] > degrees[seed])
+            {
+                seed = node;
+            }
+        }
+
+        if (exhausted[seed] || degrees[seed] + 1U < CARDINALITY_MIN_GROUP)
+        {
+            break;
+        }
+
+        // Neighbours are tried in the order of decreasing degree:
+        size_t num_candidates = 0U;
+        for (size_t node = 0U; node < num_nodes; ++node)
+        {
+            if (CARDINALITY_EDGE(remaining, seed, node))
+            {
+                candidates[num_candidates].node   = node;
+                candidates[num_candidates].degree = degrees[node];
+                num_candidates += 1U;
+            }
+        }
+
+        qsort(candidates, num_candidates, sizeof(CARDINALITY_CANDIDATE), CARDINALITY_CANDIDATE_cmp);
+
+        // Nodes adjacent to every member of the clique:
+        memcpy(common, &remaining[seed * num_words], num_words * sizeof(uint64_t));
+
+        size_t size = 0U;
+        clique[size++] = seed;
+
+        for (size_t cand_i = 0U; cand_i < num_candidates; ++cand_i)
+        {
+            size_t node = candidates[cand_i].node;
+            if (!((common[node / 64U] >> (node % 64U)) & 1U))
+            {
+                continue;
+            }
+
+            clique[size++] = node;
+
+            for (size_t word = 0U; word < num_words; ++word)
+            {
+                common[word] &= remaining[node * num_words + word];
+            }
+        }
+
+        if (size < CARDINALITY_MIN_GROUP)
+        {
+            // The seed grows no large clique:
+            exhausted[seed] = true;
+            continue;
+        }
+
+        CARDINALITY card;
+        CARDINALITY_init(&card, 1U);
+
+        for (size_t member_i = 0U; member_i < size; ++member_i)
+        {
+            CARDINALITY_insert(&card, CARDINALITY_node_literal(clique[member_i]));
+
+            // The edges of the clique are covered:
+            for (size_t other_i = member_i + 1U; other_i < size; ++other_i)
+            {
+                CARDINALITY_FLIP(remaining, clique[member_i], clique[other_i]);
+                CARDINALITY_FLIP(remaining, clique[other_i], clique[member_i]);
+
+                degrees[clique[member_i]] -= 1U;
+                degrees[clique[other_i]]  -= 1U;
+            }
+        }
+
+        FORMULA_insert_cardinality(result, card);
+        num_groups += 1U;
+    }
+
+    // Copy the clauses that are not covered by the cliques:
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        if (CLAUSE_size(cls) == 2U &&
+            LITERAL_VALUE_Get(CLAUSE_get(cls, 0U)) != LITERAL_VALUE_Get(CLAUSE_get(cls, 1U)))
+        {
+            size_t node1 = CARDINALITY_node(CLAUSE_get(cls, 0U) ^ LITERAL_CONTRARY_BIT);
+            size_t node2 = CARDINALITY_node(CLAUSE_get(cls, 1U) ^ LITERAL_CONTRARY_BIT);
+
+            if (!CARDINALITY_EDGE(remaining, node1, node2))
+            {
+                continue;
+            }
+        }
+
+        CLAUSE copy;
+        CLAUSE_init(&copy);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            CLAUSE_insert(&copy, CLAUSE_get(cls, lit_i));
+        }
+
+        FORMULA_insert(result, copy);
+    }
+
+    #undef CARDINALITY_EDGE
+    #undef CARDINALITY_FLIP
+
+    free(edges);
+    free(remaining);
+    free(degrees);
+    free(common);
+    free(clique);
+    free(exhausted);
+    free(candidates);
+
+    return num_groups;
+}
+
+#endif // DPLL_CARDINALITY_H
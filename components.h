@@ -0,0 +1,288 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_COMPONENTS_H
+#define DPLL_COMPONENTS_H
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <threads.h>
+
+#include "solver.h"
+
+//=========================//
+// Union-find on variables //
+//=========================//
+
+typedef struct
+{
+    uint16_t parent[NUM_LITERALS];
+} DISJOINT_SETS;
+
+void DISJOINT_SETS_init(DISJOINT_SETS* sets)
+{
+    for (uint16_t var = 0U; var < NUM_LITERALS; ++var)
+    {
+        sets->parent[var] = var;
+    }
+}
+
+uint16_t DISJOINT_SETS_find(DISJOINT_SETS* sets, uint16_t var)
+{
+    while (sets->parent[var] != var)
+    {
+        // Path halving:
+        sets->parent[var] = sets->parent[sets->parent[var]];
+        var = sets->parent[var];
+    }
+
+    return var;
+}
+
+void DISJOINT_SETS_unite(DISJOINT_SETS* sets, uint16_t var1, uint16_t var2)
+{
+    uint16_t root1 = DISJOINT_SETS_find(sets, var1);
+    uint16_t root2 = DISJOINT_SETS_find(sets, var2);
+
+    // Smaller variable becomes the root:
+    if (root1 < root2)
+    {
+        sets->parent[root2] = root1;
+    }
+    else
+    {
+        sets->parent[root1] = root2;
+    }
+}
+
+//=========================//
+// Component decomposition //
+//=========================//
+
+// Split the formula into variable-disjoint subformulas.
+//
+// Return the number of components stored into the array of formulas.
+size_t components_split(const FORMULA* formula, FORMULA** components)
+{
+    DISJOINT_SETS* sets = malloc(sizeof(DISJOINT_SETS));
+    VERIFY_CONTRACT(sets != NULL,
+        "[%s] Unable to allocate disjoint sets\n", "components_split");
+
+    DISJOINT_SETS_init(sets);
+
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        uint16_t first = LITERAL_VALUE_Get(CLAUSE_get(cls, 0U));
+        for (size_t lit_i = 1U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            DISJOINT_SETS_unite(sets, first, LITERAL_VALUE_Get(CLAUSE_get(cls, lit_i)));
+        }
+    }
+
+    // Enumerate components by their roots:
+    uint16_t* component_of = calloc(NUM_LITERALS, sizeof(uint16_t));
+    VERIFY_CONTRACT(component_of != NULL,
+        "[%s] Unable to allocate component index\n", "components_split");
+
+    size_t num_components = 0U;
+    for (uint16_t var = 1U; var < NUM_LITERALS; ++var)
+    {
+        literal_t lit = 0U;
+        LITERAL_VALUE_Set(lit, var);
+
+        if (!VARIABLES_literal_is_undef(&formula->variables, lit) &&
+            DISJOINT_SETS_find(sets, var) == var)
+        {
+            component_of[var] = num_components++;
+        }
+    }
+
+    *components = calloc(num_components, sizeof(FORMULA));
+    VERIFY_CONTRACT(*components != NULL,
+        "[%s] Unable to allocate %zu components\n", "components_split", num_components);
+
+    for (size_t comp_i = 0U; comp_i < num_components; ++comp_i)
+    {
+        FORMULA_init(&(*components)[comp_i]);
+    }
+
+    // Copy every clause into its component:
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        uint16_t root = DISJOINT_SETS_find(sets, LITERAL_VALUE_Get(CLAUSE_get(cls, 0U)));
+
+        CLAUSE copy;
+        CLAUSE_init(&copy);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            CLAUSE_insert(&copy, CLAUSE_get(cls, lit_i));
+        }
+
+        FORMULA_insert(&(*components)[component_of[root]], copy);
+    }
+
+    free(component_of);
+    free(sets);
+
+    return num_components;
+}
+
+//==============================//
+// Independent component solver //
+//==============================//
+
+typedef struct
+{
+    FORMULA*   components;
+    VARIABLES* models;
+    size_t     num_components;
+
+    // Next component to be scheduled:
+    atomic_size_t next;
+
+    // Cancellation flag:
+    atomic_bool refuted;
+} COMPONENT_POOL;
+
+sat_t components_solve_one(COMPONENT_POOL* pool, size_t comp_i)
+{
+    TRIAL trial;
+    FORMULA formula;
+
+    sat_t sat_flag = dpll_init_search(&pool->components[comp_i], &formula, &trial, NULL, NULL, 0U);
+
+    while (sat_flag == UNDEF)
+    {
+        // Any refuted component refutes the whole formula:
+        if (atomic_load_explicit(&pool->refuted, memory_order_relaxed))
+        {
+            break;
+        }
+
+        sat_flag = dpll_step(&trial, &formula);
+    }
+
+    if (sat_flag == SAT)
+    {
+        pool->models[comp_i] = trial.variables;
+    }
+
+    FORMULA_free(&formula);
+    TRIAL_free(&trial);
+
+    return sat_flag;
+}
+
+int components_worker_main(void* arg)
+{
+    COMPONENT_POOL* pool = arg;
+
+    while (!atomic_load(&pool->refuted))
+    {
+        size_t comp_i = atomic_fetch_add(&pool->next, 1U);
+        if (comp_i >= pool->num_components)
+        {
+            break;
+        }
+
+        if (components_solve_one(pool, comp_i) == UNSAT)
+        {
+            atomic_store(&pool->refuted, true);
+        }
+    }
+
+    return 0;
+}
+
+//
+// General component solver algorithm
+//
+
+// Preprocess the formula and solve its variable-disjoint components independently.
+// The satisfying assignment is stored into model (if not NULL).
+sat_t dpll_solve_components(const FORMULA* initial_formula, VARIABLES* model, size_t num_threads)
+{
+    TRIAL trial;
+    FORMULA formula;
+
+    sat_t sat_flag = dpll_init_search(initial_formula, &formula, &trial, NULL, NULL, 0U);
+    if (sat_flag != UNDEF)
+    {
+        if (sat_flag == SAT && model != NULL)
+        {
+            *model = trial.variables;
+        }
+
+        FORMULA_free(&formula);
+        TRIAL_free(&trial);
+
+        return sat_flag;
+    }
+
+    COMPONENT_POOL pool;
+    pool.num_components = components_split(&formula, &pool.components);
+
+    pool.models = calloc(pool.num_components, sizeof(VARIABLES));
+    VERIFY_CONTRACT(pool.models != NULL,
+        "[%s] Unable to allocate %zu models\n", "dpll_solve_components", pool.num_components);
+
+    atomic_init(&pool.next, 0U);
+    atomic_init(&pool.refuted, false);
+
+    num_threads = MIN(num_threads, pool.num_components);
+    if (num_threads <= 1U)
+    {
+        components_worker_main(&pool);
+    }
+    else
+    {
+        thrd_t* threads = calloc(num_threads, sizeof(thrd_t));
+        VERIFY_CONTRACT(threads != NULL,
+            "[%s] Unable to allocate %zu threads\n", "dpll_solve_components", num_threads);
+
+        for (size_t i = 0U; i < num_threads; ++i)
+        {
+            int ret = thrd_create(&threads[i], components_worker_main, &pool);
+            VERIFY_CONTRACT(ret == thrd_success,
+                "[%s] Unable to start thread #%zu\n", "dpll_solve_components", i);
+        }
+
+        for (size_t i = 0U; i < num_threads; ++i)
+        {
+            thrd_join(threads[i], NULL);
+        }
+
+        free(threads);
+    }
+
+    sat_flag = atomic_load(&pool.refuted)? UNSAT : SAT;
+
+    // Merge the level-zero assignment with the models of the components:
+    if (sat_flag == SAT && model != NULL)
+    {
+        *model = trial.variables;
+
+        for (size_t comp_i = 0U; comp_i < pool.num_components; ++comp_i)
+        {
+            VARIABLES_merge(model, &pool.models[comp_i]);
+        }
+    }
+
+    for (size_t comp_i = 0U; comp_i < pool.num_components; ++comp_i)
+    {
+        FORMULA_free(&pool.components[comp_i]);
+    }
+
+    free(pool.components);
+    free(pool.models);
+
+    FORMULA_free(&formula);
+    TRIAL_free(&trial);
+
+    return sat_flag;
+}
+
+#endif // DPLL_COMPONENTS_H
@@ -0,0 +1,877 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_COUNT_H
+#define DPLL_COUNT_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "solver.h"
+
+//==============================//
+// Arbitrary-precision integers //
+//==============================//
+
+// Model counts are below 2^NUM_LITERALS, so the numbers are of a fixed capacity:
+// NOTE: limbs are of 32 bits, so that the products of limbs fit into 64 bits.
+#define BIGNUM_LIMBS (NUM_LITERALS / 32U)
+
+// Largest power of ten in a limb:
+#define BIGNUM_DECIMAL_CHUNK  1000000000U
+#define BIGNUM_DECIMAL_DIGITS 9
+
+typedef struct
+{
+    // Limbs starting from the least significant one (the limbs beyond the size are zero):
+    uint32_t limbs[BIGNUM_LIMBS];
+    size_t   size;
+} BIGNUM;
+
+void BIGNUM_set(BIGNUM* num, uint32_t value)
+{
+    memset(num->limbs, 0, sizeof(num->limbs));
+
+    num->limbs[0U] = value;
+    num->size      = (value != 0U)? 1U : 0U;
+}
+
+bool BIGNUM_is_zero(const BIGNUM* num)
+{
+    return num->size == 0U;
+}
+
+void BIGNUM_trim(BIGNUM* num)
+{
+    while (num->size != 0U && num->limbs[num->size - 1U] == 0U)
+    {
+        num->size -= 1U;
+    }
+}
+
+// Add the number to the sum.
+void BIGNUM_add(BIGNUM* sum, const BIGNUM* addend)
+{
+    size_t size = (sum->size > addend->size)? sum->size : addend->size;
+
+    uint32_t carry = 0U;
+    for (size_t limb_i = 0U; limb_i < size; ++limb_i)
+    {
+        uint64_t limb = (uint64_t) sum->limbs[limb_i] + addend->limbs[limb_i] + carry;
+
+        sum->limbs[limb_i] = (uint32_t) limb;
+        carry              = (uint32_t) (limb >> 32U);
+    }
+
+    if (carry != 0U && size < BIGNUM_LIMBS)
+    {
+        sum->limbs[size++] = carry;
+    }
+
+    sum->size = size;
+}
+
+// Multiply the product by the number.
+void BIGNUM_mul(BIGNUM* product, const BIGNUM* factor)
+{
+    BIGNUM result;
+    BIGNUM_set(&result, 0U);
+
+    for (size_t limb_i = 0U; limb_i < product->size; ++limb_i)
+    {
+        uint32_t carry = 0U;
+
+        size_t limb_j = 0U;
+        for (; limb_j < factor->size && limb_i + limb_j < BIGNUM_LIMBS; ++limb_j)
+        {
+            uint64_t limb = (uint64_t) product->limbs[limb_i] * factor->limbs[limb_j] +
+                result.limbs[limb_i + limb_j] + carry;
+
+            result.limbs[limb_i + limb_j] = (uint32_t) limb;
+            carry                         = (uint32_t) (limb >> 32U);
+        }
+
+        if (limb_i + limb_j < BIGNUM_LIMBS)
+        {
+            result.limbs[limb_i + limb_j] = carry;
+        }
+    }
+
+    result.size = product->size + factor->size;
+    if (result.size > BIGNUM_LIMBS)
+    {
+        result.size = BIGNUM_LIMBS;
+    }
+
+    BIGNUM_trim(&result);
+
+    *product = result;
+}
+
+// Multiply the number by 2^bits.
+void BIGNUM_shift_left(BIGNUM* num, size_t bits)
+{
+    if (num->size == 0U || bits == 0U)
+    {
+        return;
+    }
+
+    size_t   words = bits / 32U;
+    unsigned shift = bits % 32U;
+
+    for (size_t limb_i = BIGNUM_LIMBS; limb_i-- > 0U;)
+    {
+        uint32_t high = (limb_i >= words)?      num->limbs[limb_i - words]      : 0U;
+        uint32_t low  = (limb_i >= words + 1U)? num->limbs[limb_i - words - 1U] : 0U;
+
+        num->limbs[limb_i] = (shift == 0U)? high : (high << shift) | (low >> (32U - shift));
+    }
+
+    num->size += words + 1U;
+    if (num->size > BIGNUM_LIMBS)
+    {
+        num->size = BIGNUM_LIMBS;
+    }
+
+    BIGNUM_trim(num);
+}
+
+// Print the number in decimal.
+void BIGNUM_print(const BIGNUM* num)
+{
+    // Decimal chunks starting from the least significant one:
+    uint32_t chunks[2U * BIGNUM_LIMBS];
+    size_t   num_chunks = 0U;
+
+    BIGNUM rest = *num;
+    do
+    {
+        uint64_t remainder = 0U;
+        for (size_t limb_i = rest.size; limb_i-- > 0U;)
+        {
+            uint64_t cur = (remainder << 32U) | rest.limbs[limb_i];
+
+            rest.limbs[limb_i] = (uint32_t) (cur / BIGNUM_DECIMAL_CHUNK);
+            remainder          = cur % BIGNUM_DECIMAL_CHUNK;
+        }
+
+        BIGNUM_trim(&rest);
+
+        chunks[num_chunks++] = (uint32_t) remainder;
+    }
+    while (rest.size != 0U);
+
+    printf("%"PRIu32, chunks[num_chunks - 1U]);
+    for (size_t chunk_i = num_chunks - 1U; chunk_i-- > 0U;)
+    {
+        printf("%0*"PRIu32, BIGNUM_DECIMAL_DIGITS, chunks[chunk_i]);
+    }
+}
+
+//=================//
+// Component cache //
+//=================//
+
+// Component is identified by its unassigned variables and its unsatisfied clauses:
+// every residual clause is the input clause restricted to the variables of the component.
+// The hash of the component does not depend on the order of its indices,
+// so the indices are compared by their marks instead of being sorted.
+//
+// Entries are records in a pool of 32-bit words: hash (two words), number of variables,
+// number of clauses and size of the count, followed by the limbs of the count,
+// the variables and the clauses.
+// The cache never exceeds its budget: it is flushed once the pool or the table fills up.
+#define CACHE_HEADER_WORDS 5U
+
+// Table of the cache takes this fraction of the budget:
+#define CACHE_TABLE_SHARE 8U
+
+// Table grows from this number of slots up to its share of the budget:
+#define CACHE_INITIAL_SLOTS 1024U
+
+typedef struct
+{
+    // Entries of the open addressing table are pool offsets plus one (zero for an empty slot):
+    size_t* table;
+    size_t  table_capacity;
+    size_t  max_table_capacity;
+    size_t  num_entries;
+
+    uint32_t* pool;
+    size_t    pool_size;
+    size_t    pool_capacity;
+
+    // Statistics:
+    uint64_t hits;
+    uint64_t stores;
+    uint64_t flushes;
+} COMPONENT_CACHE;
+
+// Fit the cache into the budget (zero disables the cache).
+void COMPONENT_CACHE_init(COMPONENT_CACHE* cache, size_t budget)
+{
+    cache->table_capacity     = 0U;
+    cache->max_table_capacity = 0U;
+    cache->num_entries        = 0U;
+
+    cache->pool          = NULL;
+    cache->pool_size     = 0U;
+    cache->pool_capacity = 0U;
+    cache->table         = NULL;
+
+    cache->hits    = 0U;
+    cache->stores  = 0U;
+    cache->flushes = 0U;
+
+    size_t table_bytes = budget / CACHE_TABLE_SHARE;
+    if (table_bytes < 16U * sizeof(size_t))
+    {
+        return;
+    }
+
+    cache->max_table_capacity = 16U;
+    while (2U * cache->max_table_capacity * sizeof(size_t) <= table_bytes)
+    {
+        cache->max_table_capacity *= 2U;
+    }
+
+    cache->table_capacity = (cache->max_table_capacity < CACHE_INITIAL_SLOTS)?
+        cache->max_table_capacity : CACHE_INITIAL_SLOTS;
+
+    cache->pool_capacity = (budget - cache->max_table_capacity * sizeof(size_t)) / sizeof(uint32_t);
+
+    // NOTE: the pages of the table and the pool are not touched until the entries are stored.
+    cache->table = calloc(cache->max_table_capacity, sizeof(size_t));
+    cache->pool  = malloc(cache->pool_capacity * sizeof(uint32_t));
+    VERIFY_CONTRACT(cache->table != NULL && cache->pool != NULL,
+        "[%s] Unable to allocate component cache of %zu bytes\n", "COMPONENT_CACHE_init", budget);
+}
+
+void COMPONENT_CACHE_free(COMPONENT_CACHE* cache)
+{
+    free(cache->table);
+    free(cache->pool);
+}
+
+void COMPONENT_CACHE_flush(COMPONENT_CACHE* cache)
+{
+    memset(cache->table, 0, cache->table_capacity * sizeof(size_t));
+
+    cache->num_entries = 0U;
+    cache->pool_size   = 0U;
+    cache->flushes    += 1U;
+}
+
+uint64_t COMPONENT_CACHE_record_hash(const uint32_t* record)
+{
+    return ((uint64_t) record[1U] << 32U) | record[0U];
+}
+
+size_t COMPONENT_CACHE_record_words(const uint32_t* record)
+{
+    return CACHE_HEADER_WORDS + record[4U] + record[2U] + record[3U];
+}
+
+// Mix the index into the order-independent hash (the finalizer of splitmix64).
+uint64_t COMPONENT_CACHE_mix(uint64_t index)
+{
+    index += 0x9E3779B97F4A7C15ULL;
+    index  = (index ^ (index >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    index  = (index ^ (index >> 27U)) * 0x94D049BB133111EBULL;
+
+    return index ^ (index >> 31U);
+}
+
+// Double the table and insert the records of the pool anew.
+void COMPONENT_CACHE_grow(COMPONENT_CACHE* cache)
+{
+    memset(cache->table, 0, cache->table_capacity * sizeof(size_t));
+    cache->table_capacity *= 2U;
+
+    for (size_t offset = 0U; offset < cache->pool_size; offset += COMPONENT_CACHE_record_words(&cache->pool[offset]))
+    {
+        // NOTE: the records are distinct, so the first empty slot is taken.
+        size_t slot = COMPONENT_CACHE_record_hash(&cache->pool[offset]) & (cache->table_capacity - 1U);
+        while (cache->table[slot] != 0U)
+        {
+            slot = (slot + 1U) & (cache->table_capacity - 1U);
+        }
+
+        cache->table[slot] = offset + 1U;
+    }
+}
+
+// Find the count of the component.
+// NOTE: the variables and the clauses of the component are to be marked with the stamp.
+//
+// Return true if the count of the component is cached.
+bool COMPONENT_CACHE_find(COMPONENT_CACHE* cache, uint64_t hash, uint32_t num_vars, uint32_t num_clauses,
+                          const uint32_t* var_stamps, const uint32_t* clause_stamps, uint32_t stamp,
+                          BIGNUM* count)
+{
+    size_t slot = hash & (cache->table_capacity - 1U);
+    for (; cache->table[slot] != 0U; slot = (slot + 1U) & (cache->table_capacity - 1U))
+    {
+        const uint32_t* record = &cache->pool[cache->table[slot] - 1U];
+
+        if (COMPONENT_CACHE_record_hash(record) != hash || record[2U] != num_vars || record[3U] != num_clauses)
+        {
+            continue;
+        }
+
+        // The sets are equal, as the sizes are:
+        const uint32_t* vars    = &record[CACHE_HEADER_WORDS + record[4U]];
+        const uint32_t* clauses = vars + num_vars;
+
+        bool equal = true;
+        for (uint32_t var_i = 0U; equal && var_i < num_vars; ++var_i)
+        {
+            equal = var_stamps[vars[var_i]] == stamp;
+        }
+        for (uint32_t cls_i = 0U; equal && cls_i < num_clauses; ++cls_i)
+        {
+            equal = clause_stamps[clauses[cls_i]] == stamp;
+        }
+
+        if (equal)
+        {
+            BIGNUM_set(count, 0U);
+            memcpy(count->limbs, &record[CACHE_HEADER_WORDS], record[4U] * sizeof(uint32_t));
+            count->size = record[4U];
+
+            cache->hits += 1U;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Store the count of the component that is not cached.
+void COMPONENT_CACHE_store(COMPONENT_CACHE* cache, uint64_t hash,
+                           const uint32_t* vars,    uint32_t num_vars,
+                           const uint32_t* clauses, uint32_t num_clauses, const BIGNUM* count)
+{
+    size_t record_words = CACHE_HEADER_WORDS + count->size + num_vars + num_clauses;
+    if (record_words > cache->pool_capacity)
+    {
+        return;
+    }
+
+    // Keep the table at most half full:
+    if (2U * (cache->num_entries + 1U) > cache->table_capacity &&
+        cache->table_capacity < cache->max_table_capacity)
+    {
+        COMPONENT_CACHE_grow(cache);
+    }
+
+    if (cache->pool_size + record_words > cache->pool_capacity ||
+        2U * (cache->num_entries + 1U) > cache->table_capacity)
+    {
+        COMPONENT_CACHE_flush(cache);
+    }
+
+    size_t slot = hash & (cache->table_capacity - 1U);
+    while (cache->table[slot] != 0U)
+    {
+        slot = (slot + 1U) & (cache->table_capacity - 1U);
+    }
+
+    uint32_t* record = &cache->pool[cache->pool_size];
+    record[0U] = (uint32_t) hash;
+    record[1U] = (uint32_t) (hash >> 32U);
+    record[2U] = num_vars;
+    record[3U] = num_clauses;
+    record[4U] = count->size;
+
+    uint32_t* data = &record[CACHE_HEADER_WORDS];
+    memcpy(data,                          count->limbs, count->size * sizeof(uint32_t));
+    memcpy(data + count->size,            vars,         num_vars    * sizeof(uint32_t));
+    memcpy(data + count->size + num_vars, clauses,      num_clauses * sizeof(uint32_t));
+
+    cache->table[slot]  = cache->pool_size + 1U;
+    cache->pool_size   += record_words;
+    cache->num_entries += 1U;
+    cache->stores      += 1U;
+}
+
+//=====================================//
+// Model counting by component caching //
+//=====================================//
+
+bool INDEX_eq(const uint32_t* el1, const uint32_t* el2)
+{
+    return *el1 == *el2;
+}
+
+bool INDEX_lt(const uint32_t* el1, const uint32_t* el2)
+{
+    return *el1 < *el2;
+}
+
+// Parametrize stack with index data type:
+#define DATA_T         uint32_t
+#define DATA_STRUCTURE INDEX_STORAGE
+#include "template_stack.h"
+
+typedef struct
+{
+    // Search statistics of the trial:
+    STATS search;
+
+    // Components counted by branching:
+    uint64_t components;
+
+    uint64_t cache_hits;
+    uint64_t cache_stores;
+    uint64_t cache_flushes;
+} COUNT_STATS;
+
+void COUNT_STATS_print(const COUNT_STATS* stats)
+{
+    printf("c ");
+    STATS_print_values(&stats->search);
+    printf("\n");
+
+    printf("c components %"PRIu64" cache hits %"PRIu64" stores %"PRIu64" flushes %"PRIu64"\n",
+        stats->components, stats->cache_hits, stats->cache_stores, stats->cache_flushes);
+}
+
+// Components counted between the checks of the memory limit (reading the resident set size is a system call):
+#define COUNT_MEMORY_INTERVAL 4096U
+
+typedef struct
+{
+    TRIAL   trial;
+    FORMULA formula;
+
+    // Clauses of every variable are occurs[occurs_start[var]..occurs_start[var + 1]):
+    uint32_t* occurs_start;
+    uint32_t* occurs;
+
+    // Every decomposition and every cache lookup marks the indices with a stamp of its own:
+    uint32_t* var_stamps;
+    uint32_t* clause_stamps;
+    uint32_t  stamp;
+
+    // Occurrences of the variables in the component being branched on:
+    uint32_t* scores;
+
+    // Variables and clauses of the pending components and their bounds (four per component):
+    INDEX_STORAGE vars;
+    INDEX_STORAGE clauses;
+    INDEX_STORAGE bounds;
+
+    COMPONENT_CACHE cache;
+
+    uint64_t components;
+
+    const LIMITS* limits;
+    double        deadline;
+    bool          stopped;
+} COUNTER;
+
+uint32_t count_next_stamp(COUNTER* counter)
+{
+    counter->stamp += 1U;
+
+    // The marks left before the wraparound are stale:
+    if (counter->stamp == 0U)
+    {
+        memset(counter->var_stamps,    0, NUM_LITERALS * sizeof(uint32_t));
+        memset(counter->clause_stamps, 0, (FORMULA_size(&counter->formula) + 1U) * sizeof(uint32_t));
+
+        counter->stamp = 1U;
+    }
+
+    return counter->stamp;
+}
+
+bool count_clause_is_satisfied(const COUNTER* counter, uint32_t cls_i)
+{
+    const CLAUSE* cls = FORMULA_get(&counter->formula, cls_i);
+
+    for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+    {
+        if (TRIAL_literal_is_true(&counter->trial, CLAUSE_get(cls, lit_i)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void count_component(COUNTER* counter, size_t vars_begin, size_t vars_end,
+                     size_t clauses_begin, size_t clauses_end, BIGNUM* count);
+
+// Split the unassigned variables of the component into the components of the residual formula
+// and multiply their counts. Variables left with no unsatisfied clauses take both values.
+void count_residual(COUNTER* counter, size_t vars_begin, size_t vars_end, BIGNUM* count)
+{
+    TRIAL* trial = &counter->trial;
+
+    size_t vars_top    = counter->vars.size;
+    size_t clauses_top = counter->clauses.size;
+    size_t bounds_top  = counter->bounds.size;
+
+    uint32_t stamp = count_next_stamp(counter);
+
+    size_t num_free = 0U;
+    for (size_t var_i = vars_begin; var_i < vars_end; ++var_i)
+    {
+        uint32_t var = counter->vars.array[var_i];
+
+        literal_t var_lit = 0U;
+        LITERAL_VALUE_Set(var_lit, var);
+
+        if (!TRIAL_literal_is_undef(trial, var_lit) || counter->var_stamps[var] == stamp)
+        {
+            continue;
+        }
+
+        size_t comp_vars_begin    = counter->vars.size;
+        size_t comp_clauses_begin = counter->clauses.size;
+
+        // Breadth-first search over the unsatisfied clauses:
+        counter->var_stamps[var] = stamp;
+        INDEX_STORAGE_push(&counter->vars, var);
+
+        for (size_t queue_i = comp_vars_begin; queue_i < counter->vars.size; ++queue_i)
+        {
+            uint32_t cur = counter->vars.array[queue_i];
+
+            for (uint32_t occ_i = counter->occurs_start[cur]; occ_i < counter->occurs_start[cur + 1U]; ++occ_i)
+            {
+                uint32_t cls_i = counter->occurs[occ_i];
+                if (counter->clause_stamps[cls_i] == stamp)
+                {
+                    continue;
+                }
+
+                counter->clause_stamps[cls_i] = stamp;
+                if (count_clause_is_satisfied(counter, cls_i))
+                {
+                    continue;
+                }
+
+                INDEX_STORAGE_push(&counter->clauses, cls_i);
+
+                const CLAUSE* cls = FORMULA_get(&counter->formula, cls_i);
+                for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+                {
+                    literal_t lit = CLAUSE_get(cls, lit_i);
+                    uint32_t  neighbour = LITERAL_VALUE_Get(lit);
+
+                    if (counter->var_stamps[neighbour] != stamp && TRIAL_literal_is_undef(trial, lit))
+                    {
+                        counter->var_stamps[neighbour] = stamp;
+                        INDEX_STORAGE_push(&counter->vars, neighbour);
+                    }
+                }
+            }
+        }
+
+        if (counter->clauses.size == comp_clauses_begin)
+        {
+            num_free += 1U;
+            counter->vars.size = comp_vars_begin;
+            continue;
+        }
+
+        INDEX_STORAGE_push(&counter->bounds, comp_vars_begin);
+        INDEX_STORAGE_push(&counter->bounds, counter->vars.size);
+        INDEX_STORAGE_push(&counter->bounds, comp_clauses_begin);
+        INDEX_STORAGE_push(&counter->bounds, counter->clauses.size);
+    }
+
+    BIGNUM_set(count, 1U);
+    BIGNUM_shift_left(count, num_free);
+
+    for (size_t bound_i = bounds_top; bound_i < counter->bounds.size; bound_i += 4U)
+    {
+        BIGNUM comp_count;
+        count_component(counter,
+            counter->bounds.array[bound_i],      counter->bounds.array[bound_i + 1U],
+            counter->bounds.array[bound_i + 2U], counter->bounds.array[bound_i + 3U], &comp_count);
+
+        if (counter->stopped)
+        {
+            break;
+        }
+
+        BIGNUM_mul(count, &comp_count);
+        if (BIGNUM_is_zero(count))
+        {
+            break;
+        }
+    }
+
+    counter->vars.size    = vars_top;
+    counter->clauses.size = clauses_top;
+    counter->bounds.size  = bounds_top;
+}
+
+// Count the models of the component by branching on its most frequent variable.
+void count_component(COUNTER* counter, size_t vars_begin, size_t vars_end,
+                     size_t clauses_begin, size_t clauses_end, BIGNUM* count)
+{
+    TRIAL* trial = &counter->trial;
+
+    counter->components += 1U;
+
+    uint32_t num_vars    = vars_end - vars_begin;
+    uint32_t num_clauses = clauses_end - clauses_begin;
+
+    bool caching = counter->cache.table_capacity != 0U;
+
+    // Variables and clauses of the component are marked for the comparison with the cached ones:
+    uint64_t hash = 0U;
+    if (caching)
+    {
+        uint32_t stamp = count_next_stamp(counter);
+
+        for (size_t var_i = vars_begin; var_i < vars_end; ++var_i)
+        {
+            uint32_t var = counter->vars.array[var_i];
+
+            counter->var_stamps[var] = stamp;
+            hash += COMPONENT_CACHE_mix(var);
+        }
+        for (size_t cls_i = clauses_begin; cls_i < clauses_end; ++cls_i)
+        {
+            uint32_t cls = counter->clauses.array[cls_i];
+
+            counter->clause_stamps[cls] = stamp;
+            hash += COMPONENT_CACHE_mix(NUM_LITERALS + cls);
+        }
+
+        if (COMPONENT_CACHE_find(&counter->cache, hash, num_vars, num_clauses,
+                counter->var_stamps, counter->clause_stamps, stamp, count))
+        {
+            return;
+        }
+    }
+
+    // Branch on the variable occurring in most of the unsatisfied clauses:
+    uint32_t branch_var   = 0U;
+    uint32_t branch_score = 0U;
+    for (size_t cls_i = clauses_begin; cls_i < clauses_end; ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(&counter->formula, counter->clauses.array[cls_i]);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            literal_t lit = CLAUSE_get(cls, lit_i);
+            uint32_t  var = LITERAL_VALUE_Get(lit);
+
+            if (TRIAL_literal_is_undef(trial, lit))
+            {
+                counter->scores[var] += 1U;
+                if (counter->scores[var] > branch_score)
+                {
+                    branch_var   = var;
+                    branch_score = counter->scores[var];
+                }
+            }
+        }
+    }
+
+    for (size_t var_i = vars_begin; var_i < vars_end; ++var_i)
+    {
+        counter->scores[counter->vars.array[var_i]] = 0U;
+    }
+
+    BIGNUM_set(count, 0U);
+    for (unsigned polarity = 0U; polarity < 2U; ++polarity)
+    {
+        if (LIMITS_reached(counter->limits, &trial->stats, counter->deadline) ||
+            (counter->components % COUNT_MEMORY_INTERVAL == 0U && !dpll_memory_fits(counter->limits, 0U)))
+        {
+            counter->stopped = true;
+            break;
+        }
+
+        literal_t branch_lit = (polarity == 0U)? 0U : LITERAL_CONTRARY_BIT;
+        LITERAL_VALUE_Set(branch_lit, branch_var);
+
+        uint32_t level = TRIAL_cur_level(trial);
+
+        dpll_assert_literal(trial, &counter->formula, branch_lit | LITERAL_DECISION_BIT);
+        trial->stats.decisions += 1U;
+
+        dpll_exhaustive_unit_propagate(trial, &counter->formula);
+
+        if (TRIAL_formula_is_unsat(trial))
+        {
+            trial->stats.conflicts += 1U;
+        }
+        else
+        {
+            BIGNUM branch_count;
+            count_residual(counter, vars_begin, vars_end, &branch_count);
+
+            BIGNUM_add(count, &branch_count);
+        }
+
+        dpll_backtrack_to_level(trial, level);
+
+        if (counter->stopped)
+        {
+            break;
+        }
+    }
+
+    if (caching && !counter->stopped)
+    {
+        COMPONENT_CACHE_store(&counter->cache, hash,
+            &counter->vars.array[vars_begin],       num_vars,
+            &counter->clauses.array[clauses_begin], num_clauses, count);
+    }
+}
+
+// Count the models of the formula over the variables from one to FORMULA_num_variables.
+// Unit propagation runs through the watch lists of the preprocessed formula.
+// Counts of the components are cached within the budget (measured in bytes, zero disables the cache).
+// The search is abandoned with UNDEF result once it exceeds the limits (if not NULL),
+// the memory limit also caps the cache budget.
+//
+// Return SAT if the count is not zero, UNSAT if it is.
+sat_t dpll_count(const FORMULA* formula, BIGNUM* count, COUNT_STATS* stats,
+                 const LIMITS* limits, size_t cache_budget)
+{
+    double deadline = TIME_now() + ((limits != NULL)? limits->seconds : 0.0);
+
+    // Do not build the search state that does not fit into the memory:
+    if (!dpll_memory_fits(limits, dpll_memory_estimate(formula)))
+    {
+        if (stats != NULL)
+        {
+            memset(stats, 0, sizeof(COUNT_STATS));
+            STATS_init(&stats->search);
+        }
+
+        BIGNUM_set(count, 0U);
+        return UNDEF;
+    }
+
+    ARENA arena;
+    ARENA_init(&arena, 0U);
+
+    COUNTER* counter = malloc(sizeof(COUNTER));
+    VERIFY_CONTRACT(counter != NULL,
+        "[%s] Unable to allocate model counter\n", "dpll_count");
+
+    counter->limits   = limits;
+    counter->deadline = deadline;
+    counter->stopped  = false;
+
+    counter->components = 0U;
+
+    sat_t sat_flag = dpll_init_search(formula, &counter->formula, &counter->trial, &arena, NULL, 0U);
+
+    size_t num_variables = VARIABLES_max_value(&formula->variables);
+    size_t num_clauses   = FORMULA_size(&counter->formula);
+
+    // Occurrence lists of the preprocessed formula:
+    counter->occurs_start = calloc(NUM_LITERALS + 1U, sizeof(uint32_t));
+    VERIFY_CONTRACT(counter->occurs_start != NULL,
+        "[%s] Unable to allocate occurrence lists\n", "dpll_count");
+
+    for (size_t cls_i = 0U; cls_i < num_clauses; ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(&counter->formula, cls_i);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            counter->occurs_start[LITERAL_VALUE_Get(CLAUSE_get(cls, lit_i))] += 1U;
+        }
+    }
+
+    // Every start holds the end of its list, which moves to the beginning as the list is filled:
+    for (size_t var = 1U; var <= NUM_LITERALS; ++var)
+    {
+        counter->occurs_start[var] += counter->occurs_start[var - 1U];
+    }
+
+    counter->occurs        = malloc((counter->occurs_start[NUM_LITERALS] + 1U) * sizeof(uint32_t));
+    counter->var_stamps    = calloc(NUM_LITERALS, sizeof(uint32_t));
+    counter->clause_stamps = calloc(num_clauses + 1U, sizeof(uint32_t));
+    counter->scores        = calloc(NUM_LITERALS, sizeof(uint32_t));
+    VERIFY_CONTRACT(counter->occurs != NULL && counter->var_stamps != NULL &&
+                    counter->clause_stamps != NULL && counter->scores != NULL,
+        "[%s] Unable to allocate component search\n", "dpll_count");
+
+    for (size_t cls_i = num_clauses; cls_i-- > 0U;)
+    {
+        const CLAUSE* cls = FORMULA_get(&counter->formula, cls_i);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            counter->occurs[--counter->occurs_start[LITERAL_VALUE_Get(CLAUSE_get(cls, lit_i))]] = cls_i;
+        }
+    }
+
+    counter->stamp = 0U;
+
+    INDEX_STORAGE_init(&counter->vars,    INDEX_eq, INDEX_lt, false);
+    INDEX_STORAGE_init(&counter->clauses, INDEX_eq, INDEX_lt, false);
+    INDEX_STORAGE_init(&counter->bounds,  INDEX_eq, INDEX_lt, false);
+
+    // The cache takes at most half of the memory left under the limit, the rest is for the search:
+    if (limits != NULL && limits->memory != 0U)
+    {
+        size_t rss  = MEMORY_rss();
+        size_t left = (rss < limits->memory)? (limits->memory - rss) / 2U : 0U;
+
+        cache_budget = MIN(cache_budget, left);
+    }
+
+    COMPONENT_CACHE_init(&counter->cache, cache_budget);
+
+    BIGNUM_set(count, 0U);
+    if (sat_flag != UNSAT)
+    {
+        // The whole formula is the residual of the level-zero assignment:
+        for (uint32_t var = 1U; var <= num_variables; ++var)
+        {
+            INDEX_STORAGE_push(&counter->vars, var);
+        }
+
+        count_residual(counter, 0U, num_variables, count);
+
+        // The declared variables beyond the largest one used are free:
+        BIGNUM_shift_left(count, FORMULA_num_variables(formula) - num_variables);
+    }
+
+    if (stats != NULL)
+    {
+        stats->search        = counter->trial.stats;
+        stats->components    = counter->components;
+        stats->cache_hits    = counter->cache.hits;
+        stats->cache_stores  = counter->cache.stores;
+        stats->cache_flushes = counter->cache.flushes;
+    }
+
+    sat_flag = counter->stopped? UNDEF : BIGNUM_is_zero(count)? UNSAT : SAT;
+
+    COMPONENT_CACHE_free(&counter->cache);
+
+    INDEX_STORAGE_free(&counter->vars);
+    INDEX_STORAGE_free(&counter->clauses);
+    INDEX_STORAGE_free(&counter->bounds);
+
+    free(counter->occurs_start);
+    free(counter->occurs);
+    free(counter->var_stamps);
+    free(counter->clause_stamps);
+    free(counter->scores);
+    free(counter);
+
+    ARENA_free(&arena);
+
+    return sat_flag;
+}
+
+#endif // DPLL_COUNT_H
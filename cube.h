@@ -0,0 +1,455 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_CUBE_H
+#define DPLL_CUBE_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <threads.h>
+
+#include "solver.h"
+#include "parallel.h"
+
+//==========================//
+// Lookahead cube generator //
+//==========================//
+
+typedef struct
+{
+    // Lookahead state:
+    TRIAL   trial;
+    FORMULA formula;
+
+    // Split the search tree up to this depth:
+    unsigned max_depth;
+
+    // Generated cubes:
+    JOB_STORAGE* cubes;
+} CUBER;
+
+// Decide the literal and count the literals implied by it.
+size_t cube_probe(CUBER* cuber, literal_t literal, bool* failed)
+{
+    TRIAL* trial = &cuber->trial;
+
+    size_t trial_size = trial->literals.size;
+
+    dpll_assert_literal(trial, &cuber->formula, literal | LITERAL_DECISION_BIT);
+    dpll_exhaustive_unit_propagate(trial, &cuber->formula);
+
+    size_t implied = trial->literals.size - trial_size;
+    *failed = TRIAL_formula_is_unsat(trial);
+
+    // Undo the lookahead decision:
+    literal_t dumpster;
+    TRIAL_pop_to_last_decision(trial, &dumpster);
+    trial->conflict_flag = false;
+
+    return implied;
+}
+
+// Select the branching variable by the amount of propagation it causes.
+// Failed literals are asserted with the reversed contrarity along the way.
+//
+// Return UNSAT if the current node is refuted.
+// Return SAT if the current node assigns every variable.
+// Return UNDEF and the branching literal otherwise.
+sat_t cube_lookahead(CUBER* cuber, literal_t* branch)
+{
+    TRIAL*   trial   = &cuber->trial;
+    FORMULA* formula = &cuber->formula;
+
+    bool progress;
+    do
+    {
+        progress = false;
+
+        uint64_t best_score = 0U;
+        *branch = LITERAL_NULL;
+
+        for (uint16_t slot = 0U; slot < NUM_SLOTS; ++slot)
+        {
+            uint32_t unassigned = formula->variables.used[slot] & ~trial->variables.used[slot];
+
+            for (unsigned subslot = 0U; unassigned != 0U && subslot < NUM_SUBSLOTS; ++subslot)
+            {
+                if (!(unassigned & BIT_MASK(subslot)))
+                {
+                    continue;
+                }
+
+                literal_t positive = 0U;
+                LITERAL_VALUE_Set(positive, slot * NUM_SUBSLOTS + subslot);
+
+                // The variable may be assigned by a failed literal:
+                if (!TRIAL_literal_is_undef(trial, positive))
+                {
+                    continue;
+                }
+
+                literal_t negative = positive | LITERAL_CONTRARY_BIT;
+
+                bool pos_failed, neg_failed;
+                size_t pos_implied = cube_probe(cuber, positive, &pos_failed);
+                size_t neg_implied = cube_probe(cuber, negative, &neg_failed);
+
+                if (pos_failed || neg_failed)
+                {
+                    if (pos_failed && neg_failed)
+                    {
+                        return UNSAT;
+                    }
+
+                    // Assert the only possible contrarity:
+                    dpll_assert_literal(trial, formula, pos_failed? negative : positive);
+                    dpll_exhaustive_unit_propagate(trial, formula);
+
+                    if (TRIAL_formula_is_unsat(trial))
+                    {
+                        return UNSAT;
+                    }
+
+                    progress = true;
+                    continue;
+                }
+
+                // Prefer variables that cause propagation in both branches:
+                uint64_t score = (uint64_t) (pos_implied + 1U) * (neg_implied + 1U);
+                if (score > best_score)
+                {
+                    best_score = score;
+                    *branch = (pos_implied >= neg_implied)? positive : negative;
+                }
+            }
+        }
+    }
+    while (progress && *branch == LITERAL_NULL);
+
+    return (*branch == LITERAL_NULL)? SAT : UNDEF;
+}
+
+void cube_emit(CUBER* cuber)
+{
+    const TRIAL* trial = &cuber->trial;
+
+    JOB cube;
+    cube.size     = TRIAL_cur_level(trial);
+    cube.literals = calloc((cube.size == 0U)? 1U : cube.size, sizeof(literal_t));
+    VERIFY_CONTRACT(cube.literals != NULL,
+        "[%s] Unable to allocate cube of size %zu\n", "cube_emit", cube.size);
+
+    // Cube consists of the decisions:
+    size_t cube_i = 0U;
+    for (size_t lit_i = 0U; lit_i < trial->literals.size; ++lit_i)
+    {
+        literal_t lit = LIT_STORAGE_get(&trial->literals, lit_i);
+        if (lit & LITERAL_DECISION_BIT)
+        {
+            cube.literals[cube_i++] = lit & ~LITERAL_DECISION_BIT;
+        }
+    }
+
+    JOB_STORAGE_push(cuber->cubes, cube);
+}
+
+// Split the search tree of the current node into cubes.
+//
+// Return SAT if a satisfying assignment is found during the lookahead
+// (the trial holds the assignment then).
+sat_t cube_split(CUBER* cuber, unsigned depth)
+{
+    TRIAL* trial = &cuber->trial;
+
+    literal_t branch;
+    sat_t sat_flag = cube_lookahead(cuber, &branch);
+    if (sat_flag != UNDEF)
+    {
+        // Refuted nodes produce no cubes:
+        return sat_flag;
+    }
+
+    if (depth == cuber->max_depth)
+    {
+        cube_emit(cuber);
+        return UNDEF;
+    }
+
+    for (unsigned branch_i = 0U; branch_i < 2U; ++branch_i)
+    {
+        dpll_assert_literal(trial, &cuber->formula, branch | LITERAL_DECISION_BIT);
+        dpll_exhaustive_unit_propagate(trial, &cuber->formula);
+
+        if (!TRIAL_formula_is_unsat(trial))
+        {
+            if (cube_split(cuber, depth + 1U) == SAT)
+            {
+                return SAT;
+            }
+        }
+
+        literal_t dumpster;
+        TRIAL_pop_to_last_decision(trial, &dumpster);
+        trial->conflict_flag = false;
+
+        branch ^= LITERAL_CONTRARY_BIT;
+    }
+
+    return UNDEF;
+}
+
+// Generate cubes covering every non-refuted subtree of depth max_depth.
+// The satisfying assignment found by the lookahead is stored into model (if not NULL).
+//
+// Return SAT/UNSAT if the formula is solved by the lookahead itself.
+sat_t cube_generate(const FORMULA* initial, unsigned max_depth, JOB_STORAGE* cubes, VARIABLES* model)
+{
+    CUBER cuber;
+    cuber.max_depth = max_depth;
+    cuber.cubes     = cubes;
+
+    JOB_STORAGE_init(cubes, JOB_eq, JOB_lt, false /*sorted*/);
+
+    sat_t sat_flag = dpll_init_search(initial, &cuber.formula, &cuber.trial, NULL, NULL, 0U);
+    if (sat_flag == UNDEF)
+    {
+        dpll_exhaustive_unit_propagate(&cuber.trial, &cuber.formula);
+        if (TRIAL_formula_is_unsat(&cuber.trial))
+        {
+            sat_flag = UNSAT;
+        }
+    }
+
+    if (sat_flag == UNDEF)
+    {
+        sat_flag = cube_split(&cuber, 0U);
+    }
+
+    // Every subtree is refuted by the lookahead:
+    if (sat_flag == UNDEF && cubes->size == 0U)
+    {
+        sat_flag = UNSAT;
+    }
+
+    if (sat_flag == SAT && model != NULL)
+    {
+        *model = cuber.trial.variables;
+    }
+
+    FORMULA_free(&cuber.formula);
+    TRIAL_free(&cuber.trial);
+
+    return sat_flag;
+}
+
+void cube_free_all(JOB_STORAGE* cubes)
+{
+    for (size_t cube_i = 0U; cube_i < cubes->size; ++cube_i)
+    {
+        JOB_free(JOB_STORAGE_get_ptr(cubes, cube_i));
+    }
+
+    JOB_STORAGE_free(cubes);
+}
+
+//===============//
+// Cube file I/O //
+//===============//
+
+// Cubes are stored in the iCNF notation: "a <literals> 0" per line.
+void cube_write_file(const char* filename, const JOB_STORAGE* cubes)
+{
+    FILE* file = fopen(filename, "w");
+    VERIFY_CONTRACT(file != NULL,
+        "[cube_write_file] Unable to open file %s\n", filename);
+
+    for (size_t cube_i = 0U; cube_i < cubes->size; ++cube_i)
+    {
+        const JOB* cube = JOB_STORAGE_get_ptr(cubes, cube_i);
+
+        fprintf(file, "a");
+        for (size_t lit_i = 0U; lit_i < cube->size; ++lit_i)
+        {
+            fprintf(file, " %d", LITERAL_value(cube->literals[lit_i]));
+        }
+        fprintf(file, " 0\n");
+    }
+
+    fclose(file);
+}
+
+void cube_read_file(const char* filename, JOB_STORAGE* cubes)
+{
+    JOB_STORAGE_init(cubes, JOB_eq, JOB_lt, false /*sorted*/);
+
+    FILE* file = fopen(filename, "r");
+    VERIFY_CONTRACT(file != NULL,
+        "[cube_read_file] Unable to open file %s\n", filename);
+
+    LIT_STORAGE literals;
+    LIT_STORAGE_init(&literals, &LITERAL_eq_contrarity, &LITERAL_lt, false /*sorted*/);
+
+    char token[16U];
+    while (fscanf(file, "%15s", token) == 1)
+    {
+        if (strcmp(token, "a") == 0)
+        {
+            continue;
+        }
+
+        int value = atoi(token);
+        VERIFY_CONTRACT(abs(value) < (int) NUM_LITERALS,
+            "[cube_read_file] Solver supports literals up to %d (got %d)\n",
+            NUM_LITERALS, abs(value));
+
+        if (value != 0)
+        {
+            literal_t lit = (value < 0)? LITERAL_CONTRARY_BIT : 0U;
+            LITERAL_VALUE_Set(lit, abs(value));
+
+            LIT_STORAGE_push(&literals, lit);
+            continue;
+        }
+
+        // Cube terminator:
+        JOB cube;
+        cube.size     = literals.size;
+        cube.literals = calloc((cube.size == 0U)? 1U : cube.size, sizeof(literal_t));
+        VERIFY_CONTRACT(cube.literals != NULL,
+            "[cube_read_file] Unable to allocate cube of size %zu\n", cube.size);
+
+        memcpy(cube.literals, literals.array, cube.size * sizeof(literal_t));
+        JOB_STORAGE_push(cubes, cube);
+
+        literals.size = 0U;
+    }
+
+    LIT_STORAGE_free(&literals);
+    fclose(file);
+}
+
+//==========================//
+// Parallel cube conquering //
+//==========================//
+
+typedef struct
+{
+    const FORMULA*     formula;
+    const JOB_STORAGE* cubes;
+
+    // Range of cubes to be conquered:
+    size_t last;
+
+    // Next cube to be scheduled:
+    atomic_size_t next;
+
+    // Cancellation flag:
+    atomic_bool satisfied;
+
+    // Satisfying assignment (if not NULL):
+    VARIABLES* model;
+} CONQUEROR;
+
+// Solve the formula under the cube.
+// The satisfying assignment is stored into model.
+sat_t cube_conquer_one(CONQUEROR* conqueror, const JOB* cube, VARIABLES* model)
+{
+    TRIAL trial;
+    FORMULA formula;
+
+    sat_t sat_flag = dpll_init_search(conqueror->formula, &formula, &trial, NULL,
+                                      cube->literals, cube->size);
+
+    while (sat_flag == UNDEF)
+    {
+        // Cancel the search as soon as some cube is satisfied:
+        if (atomic_load_explicit(&conqueror->satisfied, memory_order_relaxed))
+        {
+            break;
+        }
+
+        sat_flag = dpll_step(&trial, &formula);
+    }
+
+    if (sat_flag == SAT)
+    {
+        *model = trial.variables;
+    }
+
+    FORMULA_free(&formula);
+    TRIAL_free(&trial);
+
+    return sat_flag;
+}
+
+int cube_conquer_main(void* arg)
+{
+    CONQUEROR* conqueror = arg;
+
+    while (!atomic_load(&conqueror->satisfied))
+    {
+        // Dynamic scheduling:
+        size_t cube_i = atomic_fetch_add(&conqueror->next, 1U);
+        if (cube_i >= conqueror->last)
+        {
+            break;
+        }
+
+        const JOB* cube = JOB_STORAGE_get_ptr(conqueror->cubes, cube_i);
+
+        // Only the first satisfied cube reports its model:
+        VARIABLES model;
+        if (cube_conquer_one(conqueror, cube, &model) == SAT &&
+            !atomic_exchange(&conqueror->satisfied, true) && conqueror->model != NULL)
+        {
+            *conqueror->model = model;
+        }
+    }
+
+    return 0;
+}
+
+// Solve the cubes in range [first, last) on a pool of threads.
+//
+// The satisfying assignment is stored into model (if not NULL).
+//
+// Return UNSAT if the range covers every cube and all of them are refuted,
+// UNDEF if the cubes in range are refuted, but some cubes are left out of it.
+sat_t cube_conquer(const FORMULA* initial, const JOB_STORAGE* cubes,
+                   size_t first, size_t last, VARIABLES* model, size_t num_threads)
+{
+    CONQUEROR conqueror;
+    conqueror.formula = initial;
+    conqueror.cubes   = cubes;
+    conqueror.last    = MIN(last, cubes->size);
+    conqueror.model   = model;
+
+    atomic_init(&conqueror.next, first);
+    atomic_init(&conqueror.satisfied, false);
+
+    thrd_t* threads = calloc(num_threads, sizeof(thrd_t));
+    VERIFY_CONTRACT(threads != NULL,
+        "[%s] Unable to allocate %zu threads\n", "cube_conquer", num_threads);
+
+    for (size_t i = 0U; i < num_threads; ++i)
+    {
+        int ret = thrd_create(&threads[i], cube_conquer_main, &conqueror);
+        VERIFY_CONTRACT(ret == thrd_success,
+            "[%s] Unable to start thread #%zu\n", "cube_conquer", i);
+    }
+
+    for (size_t i = 0U; i < num_threads; ++i)
+    {
+        thrd_join(threads[i], NULL);
+    }
+
+    free(threads);
+
+    if (atomic_load(&conqueror.satisfied))
+    {
+        return SAT;
+    }
+
+    return (first == 0U && last >= cubes->size)? UNSAT : UNDEF;
+}
+
+#endif // DPLL_CUBE_H
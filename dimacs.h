@@ -6,14 +6,99 @@
 #include <stdio.h>
 #include <errno.h>
 #include <ctype.h>
+#include <string.h>
 
 #include "utils.h"
 #include "formula.h"
+#include "profile.h"
 
-#define MAX_LINE_LENGTH 120U
+// Parse the cardinality constraint line of the CNF+ format: "l1 l2 ... ln <= k" or "l1 l2 ... ln >= k".
+// At-least constraints are stored as at-most constraints over the negated literals.
+// NOTE: the constraint that no assignment satisfies is stored as the empty clause,
+//       the constraint that every assignment satisfies is dropped.
+void DIMACS_load_cardinality(FORMULA* formula, const char* line, size_t line_i)
+{
+    CARDINALITY card;
+    CARDINALITY_init(&card, 0U);
+
+    const char* cur = line;
+    while (true)
+    {
+        while (*cur != '\0' && isspace(*cur))
+        {
+            cur += 1U;
+        }
+
+        if (*cur == '<' || *cur == '>')
+        {
+            break;
+        }
+
+        char* endptr = NULL;
+        int value = strtol(cur, &endptr, 10U);
+        VERIFY_CONTRACT(abs(value) < NUM_LITERALS,
+            "[DIMACS_load_formula] Solver supports literals up to %d (got %u)",
+            NUM_LITERALS, abs(value));
+
+        // Stop at a malformed literal (it is reported below):
+        if (cur == endptr || value == 0 || abs(value) >= NUM_LITERALS)
+        {
+            break;
+        }
+
+        // Ensure progress:
+        cur = endptr;
+
+        CARDINALITY_insert(&card, LITERAL_from_value(value));
+    }
+
+    bool at_least = (*cur == '>');
+
+    char* endptr = NULL;
+    long bound = (*cur == '<' || at_least)? strtol(cur + 2U, &endptr, 10U) : -1;
+
+    // NOTE: the constraint is rejected as a whole, as dropping any part of it changes the solutions.
+    if ((*cur != '<' && !at_least) || cur[1U] != '=' || cur + 2U == endptr || bound < 0)
+    {
+        printf("[DIMACS_load_formula] Unable to read cardinality constraint on line %zu\n", line_i);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t size = CARDINALITY_size(&card);
+    if (at_least)
+    {
+        for (size_t lit_i = 0U; lit_i < size; ++lit_i)
+        {
+            card.literals.array[lit_i] ^= LITERAL_CONTRARY_BIT;
+        }
+
+        if ((size_t) bound > size)
+        {
+            CARDINALITY_free(&card);
+
+            CLAUSE empty;
+            CLAUSE_init(&empty);
+            FORMULA_insert(formula, empty);
+            return;
+        }
+
+        bound = size - bound;
+    }
+
+    if ((size_t) bound >= size)
+    {
+        CARDINALITY_free(&card);
+        return;
+    }
+
+    card.bound = bound;
+    FORMULA_insert_cardinality(formula, card);
+}
 
 void DIMACS_load_formula(const char* filename, FORMULA* formula)
 {
+    PROFILE_BEGIN(PROFILE_LOAD_FORMULA);
+
     // Initialize formula:
     FORMULA_init(formula);
 
@@ -24,29 +109,22 @@ void DIMACS_load_formula(const char* filename, FORMULA* formula)
 
     // Problem information:
     bool entered_problem = false;
+    bool cardinalities   = false;
     unsigned num_variables = 0U;
     unsigned num_clauses = 0U;
 
-    // NOTE: +1 is for \n and +1 is for null-terminator.
-    char line[MAX_LINE_LENGTH + 2U];
+    // NOTE: lines are of arbitrary length.
+    char*  line          = NULL;
+    size_t line_capacity = 0U;
+
+    // Clause being read (it may span over several lines):
+    CLAUSE new_clause;
+    bool   clause_open = false;
 
     // Read the whole file:
     unsigned clause_i = 0U;
-    for (size_t line_i = 0U; true; line_i++)
+    for (size_t line_i = 0U; getline(&line, &line_capacity, cnf_file) != -1; line_i++)
     {
-        // Read input line:
-        char* ret = fgets(line, MAX_LINE_LENGTH + 1U, cnf_file);
-        if (ret == NULL)
-        {
-            break;
-        }
-
-        // Get line length:
-        size_t len = strlen(line);
-        VERIFY_CONTRACT(len > 0 && line[len - 1U] == '\n',
-            "[DIMACS_load_formula] Line %zu is too long (expected up to %u characters)\n",
-            line_i, MAX_LINE_LENGTH);
-
         // Parse comment lines:
         if (line[0] == 'c')
         {
@@ -63,29 +141,50 @@ void DIMACS_load_formula(const char* filename, FORMULA* formula)
             VERIFY_CONTRACT(entered_problem == false,
                 "[DIMACS_load_formula] Line %zu is a duplicate problem line\n", line_i);
 
+            // The CNF+ format also allows for cardinality constraints:
             char dumpster[10U];
-            int ret = sscanf(line, "p cnf %u%10[ ]%u",
+            int ret = sscanf(line, "p cnf+ %u%10[ ]%u",
                 &num_variables, dumpster, &num_clauses);
+            if (ret == 3)
+            {
+                cardinalities = true;
+            }
+            else
+            {
+                ret = sscanf(line, "p cnf %u%10[ ]%u",
+                    &num_variables, dumpster, &num_clauses);
+            }
             VERIFY_CONTRACT(ret == 3,
                 "[DIMACS_load_formula] Line %zu has invalid format\n", line_i);
 
             entered_problem = true;
         }
-        // Parse clause:
-        else
+        // Parse cardinality constraint (it is counted as a clause):
+        else if (cardinalities && (strstr(line, "<=") != NULL || strstr(line, ">=") != NULL))
         {
-            CLAUSE new_clause;
-            CLAUSE_init(&new_clause);
+            VERIFY_CONTRACT(!clause_open,
+                "[DIMACS_load_formula] Line %zu interrupts a clause\n", line_i);
 
+            DIMACS_load_cardinality(formula, line, line_i);
+            clause_i += 1U;
+        }
+        // Parse clause literals:
+        else
+        {
             char* cur = line;
-            // Handle spurious leading whitespace:
-            while (*cur != '\0' && isspace(*cur))
-            {
-                cur += 1U;
-            }
-
             while (true)
             {
+                // Handle spurious whitespace:
+                while (*cur != '\0' && isspace(*cur))
+                {
+                    cur += 1U;
+                }
+
+                if (*cur == '\0')
+                {
+                    break;
+                }
+
                 // Read a value from line:
                 char* endptr = NULL;
                 int value = strtol(cur, &endptr, 10U);
@@ -96,38 +195,59 @@ void DIMACS_load_formula(const char* filename, FORMULA* formula)
                     "[DIMACS_load_formula] Solver supports literals up to %d (got %u)",
                     NUM_LITERALS, abs(value));
 
+                // Skip the rest of a malformed line:
+                if (cur == endptr)
+                {
+                    break;
+                }
+
                 // Ensure progress:
                 cur = endptr;
 
-                if (value == 0)
+                if (!clause_open)
                 {
-                    break;
+                    CLAUSE_init(&new_clause);
+                    clause_open = true;
                 }
 
-                // Construct literal:
-                literal_t lit = 0U;
-                lit |= (value < 0)? LITERAL_CONTRARY_BIT : 0U;
-                LITERAL_VALUE_Set(lit, abs(value));
+                if (value == 0)
+                {
+                    // Insert clause into formula:
+                    FORMULA_insert(formula, new_clause);
+                    clause_open = false;
+
+                    clause_i += 1U;
+                    continue;
+                }
 
                 // Insert literal into clause:
-                CLAUSE_insert(&new_clause, lit);
+                CLAUSE_insert(&new_clause, LITERAL_from_value(value));
             }
+        }
+    }
 
-            // Insert clause into formula:
-            FORMULA_insert(formula, new_clause);
+    free(line);
 
-            clause_i += 1U;
-        }
+    // Accept the last clause with no terminating zero:
+    if (clause_open)
+    {
+        FORMULA_insert(formula, new_clause);
+        clause_i += 1U;
     }
 
     VERIFY_CONTRACT(entered_problem == true,
         "[DIMACS_load_formula] File %s has no problem line\n", filename);
 
+    // Variables that occur in no clause still count (they are free in every model):
+    formula->num_variables = num_variables;
+
     VERIFY_CONTRACT(clause_i == num_clauses,
         "[DIMACS_load_formula] File %s has mismatched number of clauses (expected %d, got %d)\n",
         filename, num_clauses, clause_i);
 
     fclose(cnf_file);
+
+    PROFILE_END(PROFILE_LOAD_FORMULA);
 }
 
 
@@ -1,750 +1,376 @@
 // No copyright. Vladislav Aleinik, 2023
 
 #include <stdlib.h>
+#include <signal.h>
 
 #include "dimacs.h"
+#include "solver.h"
+#include "parallel.h"
+#include "cube.h"
+#include "batch.h"
+#include "components.h"
+#include "generator.h"
+#include "model.h"
+#include "reorder.h"
+#include "cardinality.h"
+#include "count.h"
+#include "options.h"
 
-// Convenient naming:
-typedef enum
-{
-    UNSAT = 0,
-    SAT   = 1,
-    UNDEF = 2
-} sat_t;
+//=======================//
+// Assembled DPLL-solver //
+//=======================//
 
-//==========================//
-// Watch list implemetation //
-//==========================//
+// Exit codes of SAT solvers:
+#define EXIT_UNKNOWN  0
+#define EXIT_SAT     10
+#define EXIT_UNSAT   20
 
-#define DATA_T         const CLAUSE*
-#define DATA_STRUCTURE WATCHED_STORAGE
-#include "template_stack.h"
+volatile sig_atomic_t dpll_interrupted = 0;
 
-bool CLAUSE_PTR_eq(const CLAUSE** el1, const CLAUSE** el2)
+// Stop the search on the first signal, terminate on the second one.
+void dpll_interrupt(int signal_number)
 {
-    return *el1 == *el2;
-}
+    dpll_interrupted = 1;
 
-bool CLAUSE_PTR_lt(const CLAUSE** el1, const CLAUSE** el2)
-{
-    BUG_ON(false, "[%s] Invalid operation", "CLAUSE_PTR_lt");
+    signal(signal_number, SIG_DFL);
 }
 
-typedef struct
+// Run the local search with the flip budget of the options.
+sat_t dpll_local_search(const OPTIONS* options, const FORMULA* formula, VARIABLES* model, const LIMITS* limits)
 {
-    WATCHED_STORAGE* clause_lists;
-    size_t num_literals;
-} WATCH_LIST;
+    uint64_t flips = 0U;
+    sat_t ret = local_search_solve(formula, model, options->flips, options->seed, limits, &flips);
 
-void WATCH_LIST_init(WATCH_LIST* wl, size_t num_literals)
-{
-    wl->num_literals = num_literals;
-    wl->clause_lists = calloc(2U*num_literals, sizeof(WATCHED_STORAGE));
-    for (size_t i = 0U; i < 2U*num_literals; ++i)
+    if (options->stats)
     {
-        WATCHED_STORAGE_init(&wl->clause_lists[i],
-            CLAUSE_PTR_eq, CLAUSE_PTR_lt, false);
+        printf("c local search flips %"PRIu64" %s\n", flips, (ret == SAT)? "satisfied" : "exhausted");
     }
+
+    return ret;
 }
 
-WATCHED_STORAGE* WATCH_LIST_get(WATCH_LIST* wl, literal_t lit)
+int main(int argc, char* argv[])
 {
-    size_t index = LITERAL_VALUE_Get(lit) - 1U;
+    // Parse input arguments:
+    OPTIONS options;
+    OPTIONS_parse(&options, argc, argv);
 
-    if (lit & LITERAL_CONTRARY_BIT)
+    if (options.batch_mode)
     {
-        index += wl->num_literals;
+        dpll_solve_batch(options.inputs, options.num_inputs, options.num_jobs);
+
+        OPTIONS_free(&options);
+        return EXIT_SUCCESS;
     }
 
-    return &wl->clause_lists[index];
-}
+    size_t num_jobs = (options.num_jobs == 0U)? 1U : options.num_jobs;
 
-void WATCH_LIST_link_initial(WATCH_LIST* wl, const FORMULA* formula)
-{
-    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    FORMULA to_solve;
+    if (options.generate != NULL)
     {
-        CLAUSE* cls = FORMULA_get(formula, cls_i);
-
-        // Add both wathes to watch initial watch lists:
-        literal_t watch1 = CLAUSE_watch1(cls);
-        literal_t watch2 = CLAUSE_watch2(cls);
+        const GENERATOR_SPEC* spec = &options.generator;
 
-        WATCHED_STORAGE* wl1 = WATCH_LIST_get(wl, watch1);
-        WATCHED_STORAGE* wl2 = WATCH_LIST_get(wl, watch2);
-
-        if (!WATCHED_STORAGE_find(wl1, cls))
+        if (options.generate_out != NULL)
         {
-            WATCHED_STORAGE_push(wl1, cls);
+            generator_write_dimacs(spec, options.seed, options.generate, options.generate_out);
+            printf("c %zu variables, %zu clauses written to %s\n",
+                spec->num_variables, spec->num_clauses, options.generate_out);
+
+            OPTIONS_free(&options);
+            return EXIT_SUCCESS;
         }
 
-        if (!WATCHED_STORAGE_find(wl2, cls))
+        if (spec->num_variables >= NUM_LITERALS)
         {
-            WATCHED_STORAGE_push(wl2, cls);
-        }
-    }
-}
+            printf("Solver supports up to %u variables (%s has %zu)\n",
+                NUM_LITERALS - 1U, options.generate, spec->num_variables);
 
-void WATCH_LIST_set(WATCH_LIST* wl, literal_t lit, WATCHED_STORAGE ws)
-{
-    size_t index = LITERAL_VALUE_Get(lit) - 1U;
+            OPTIONS_free(&options);
+            return EXIT_FAILURE;
+        }
 
-    if (lit & LITERAL_CONTRARY_BIT)
-    {
-        index += wl->num_literals;
+        generator_load_formula(spec, options.seed, &to_solve);
     }
-
-    WATCHED_STORAGE_free(&wl->clause_lists[index]);
-
-    wl->clause_lists[index] = ws;
-}
-
-void WATCH_LIST_free(WATCH_LIST* wl)
-{
-    for (size_t i = 0U; i < 2U*wl->num_literals; ++i)
+    else
     {
-        WATCHED_STORAGE_free(&wl->clause_lists[i]);
+        DIMACS_load_formula(options.filename, &to_solve);
     }
-}
 
-void WATCH_LIST_print(WATCH_LIST* wl, const FORMULA* formula)
-{
-    for (size_t index = 0U; index < 2U * wl->num_literals; ++index)
+    // Models and counts cover every declared variable:
+    if (FORMULA_num_variables(&to_solve) >= NUM_LITERALS)
     {
-        int value = (index % wl->num_literals) + 1;
-        if (index >= wl->num_literals)
-        {
-            value *= -1;
-        }
-
-        WATCHED_STORAGE* ws = &wl->clause_lists[index];
+        printf("Solver supports up to %u variables (%s declares %zu)\n",
+            NUM_LITERALS - 1U, options.filename, FORMULA_num_variables(&to_solve));
 
-        if (ws->size == 0U)
-        {
-            continue;
-        }
+        FORMULA_free(&to_solve);
+        OPTIONS_free(&options);
 
-        printf("WL[%4d]", value);
-
-        for (size_t cls_i = 0U; cls_i < ws->size; ++cls_i)
-        {
-            // Fuck with the type system a bit more:
-            CLAUSE* cls = (CLAUSE*)(void*) WATCHED_STORAGE_get(ws, cls_i);
-
-            size_t cls_i = cls - formula->clauses.array;
-
-            printf(" %4zu", cls_i);
-        }
-
-        printf("\n");
+        return EXIT_FAILURE;
     }
-}
-
-//================================//
-// Assertion trial data structure //
-//================================//
-
-typedef struct {
-    // Asserted literals:
-    LIT_STORAGE literals;
-    LIT_STORAGE assertion_queue;
 
-    // Current level:
-    uint32_t level;
-
-    // Variables used in current trial:
-    VARIABLES variables;
-
-    // Variables not used in current trial:
-    VARIABLES unselected;
-
-    // Flag used to check for unsatisfyibility:
-    bool conflict_flag;
-
-    // Watch list:
-    WATCH_LIST wl;
-} TRIAL;
-
-void TRIAL_init(TRIAL* trial, size_t num_literals)
-{
-    LIT_STORAGE_init(
-        &trial->literals,
-        &LITERAL_eq_contrarity,
-        &LITERAL_lt,
-        false);
-
-    LIT_STORAGE_init(
-        &trial->assertion_queue,
-        &LITERAL_eq_contrarity,
-        &LITERAL_lt,
-        false);
-
-    trial->level = 0U;
-
-    VARIABLES_init(&trial->variables);
-    VARIABLES_init(&trial->unselected);
+    // Cardinality constraints of the input are propagated by the sequential search only:
+    if (FORMULA_num_cardinalities(&to_solve) != 0U &&
+        (options.local_search || options.local_search_first || options.cube_mode || options.components ||
+         num_jobs > 1U || options.proof != NULL || options.reorder != REORDER_NONE || options.count))
+    {
+        printf("Cardinality constraints of %s are supported by the sequential search only\n", options.filename);
 
-    trial->conflict_flag = false;
+        FORMULA_free(&to_solve);
+        OPTIONS_free(&options);
 
-    WATCH_LIST_init(&trial->wl, num_literals);
-}
+        return EXIT_FAILURE;
+    }
 
-void TRIAL_free(TRIAL* trial)
-{
-    LIT_STORAGE_free(&trial->literals);
-    LIT_STORAGE_free(&trial->assertion_queue);
-    WATCH_LIST_free(&trial->wl);
-}
+    // The input formula is kept to check the model of the transformed one:
+    FORMULA input = to_solve;
+    bool keep_input = options.reorder != REORDER_NONE || options.detect_amo;
 
-void TRIAL_print(TRIAL* trial)
-{
-    for (size_t lit_i = 0U; lit_i < trial->literals.size; ++lit_i)
+    RENUMBERING renumbering;
+    if (options.reorder != REORDER_NONE)
     {
-        literal_t lit = LIT_STORAGE_get(&trial->literals, lit_i);
-
-        printf("%5d ", LITERAL_value(lit));
+        RENUMBERING_init(&renumbering, &input, options.reorder);
+        RENUMBERING_apply(&renumbering, &input, &to_solve);
     }
 
-    printf("\n");
-}
-
-// Current level for a trial - number of decision literals in it.
-// trial_cur_level(trial) = length(trial_decisions(trial))
-uint32_t TRIAL_cur_level(const TRIAL* trial)
-{
-    return trial->level;
-}
-
-bool TRIAL_literal_is_true(const TRIAL* trial, literal_t lit)
-{
-    return VARIABLES_literal_is_true(&trial->variables, lit);
-}
-
-bool TRIAL_literal_is_false(const TRIAL* trial, literal_t lit)
-{
-    return VARIABLES_literal_is_false(&trial->variables, lit);
-}
-
-bool TRIAL_literal_is_undef(const TRIAL* trial, literal_t lit)
-{
-    return VARIABLES_literal_is_undef(&trial->variables, lit);
-}
-
-void TRIAL_add_to_assertion_queue(TRIAL* trial, literal_t literal)
-{
-    if (!LIT_STORAGE_find(&trial->assertion_queue, literal))
+    if (options.detect_amo)
     {
-        // Enqueue literal:
-        LIT_STORAGE_insert(&trial->assertion_queue, literal, 0U);
-    }
-}
+        FORMULA pairwise = to_solve;
+        size_t num_detected = CARDINALITY_detect_at_most_one(&pairwise, &to_solve);
 
-// Checks whether a given assertion trial unsatisfies a formula:
-bool TRIAL_formula_is_unsat(const TRIAL* trial)
-{
-    #ifndef NDEBUG
-    printf("[CHECK SAT ] Trial is %s\n", trial->conflict_flag? "UNSAT" : "SAT");
-    #endif
+        if (options.stats)
+        {
+            printf("c at-most-one constraints %zu detected\n", num_detected);
+        }
 
-    return trial->conflict_flag;
-}
+        if (options.reorder != REORDER_NONE)
+        {
+            FORMULA_free(&pairwise);
+        }
+    }
 
-void TRIAL_pop_to_last_decision(TRIAL* trial, literal_t* literal)
-{
-    bool ret;
-    do
+    // Satisfying assignment found by any of the search modes:
+    VARIABLES assignment;
+    VARIABLES_init(&assignment);
+
+    LIMITS limits;
+    LIMITS_init(&limits);
+    limits.memory       = 1024U * 1024U * options.mem_limit;
+    limits.seconds      = options.time_limit;
+    limits.conflicts    = options.conflict_limit;
+    limits.decisions    = options.decision_limit;
+    limits.propagations = options.propagation_limit;
+    limits.interrupted  = &dpll_interrupted;
+
+    // Only the sequential searches are able to stop in the middle:
+    if (options.local_search || (!options.cube_mode && !options.components && num_jobs == 1U))
     {
-        literal_t dumpster;
-        ret = LIT_STORAGE_pop(&trial->assertion_queue, &dumpster);
+        signal(SIGINT,  dpll_interrupt);
+        signal(SIGTERM, dpll_interrupt);
     }
-    while (ret);
 
-    do
+    sat_t ret = UNDEF;
+    if (options.local_search)
     {
-        bool ret = LIT_STORAGE_pop(&trial->literals, literal);
-        BUG_ON(!ret, "[%s] Expected at least one decision literal!", "trial_pop_to_last_decision");
-
-        VARIABLES_remove_literal(&trial->variables,  *literal);
-        VARIABLES_assert_literal(&trial->unselected, *literal);
+        ret = dpll_local_search(&options, &to_solve, &assignment, &limits);
     }
-    while (!(*literal & LITERAL_DECISION_BIT));
-
-    trial->level -= 1U;
-}
-
-//================//
-// DPLL algorithm //
-//================//
-
-//
-// Debugging utility
-//
-#define RED     "\033[1;31m"
-#define GREEN   "\033[1;32m"
-#define YELLOW  "\033[1;33m"
-#define MAGENTA "\033[1;35m"
-#define RESET   "\033[0m"
-
-void dpll_print_progress(TRIAL* trial, FORMULA* formula)
-{
-    TRIAL_print(trial);
-
-    printf("[TO ASSERT ] ");
-    for (size_t lit_i = 0U; lit_i < trial->assertion_queue.size; ++lit_i)
+    else if (options.local_search_first && dpll_local_search(&options, &to_solve, &assignment, &limits) == SAT)
     {
-        literal_t lit = LIT_STORAGE_get(&trial->assertion_queue, lit_i);
-
-        printf(YELLOW"%5d ", LITERAL_value(lit));
+        // Satisfiable instances are often solved by the local search right away:
+        ret = SAT;
     }
-    printf("\n"RESET);
-
-    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    else if (options.count)
     {
-        CLAUSE* cls = FORMULA_get(formula, cls_i);
+        BIGNUM count;
+        COUNT_STATS stats;
+        ret = dpll_count(&to_solve, &count, &stats, &limits, 1024U * 1024U * options.count_cache);
 
-        printf("[CLAUSE %3zu] ", cls_i);
-
-        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        // The statistics of an abandoned count are always reported:
+        if (options.stats || ret == UNDEF)
         {
-            literal_t lit = CLAUSE_get(cls, lit_i);
-
-            const char* color = TRIAL_literal_is_false(trial, lit)? RED    :
-                                TRIAL_literal_is_true(trial, lit) ? GREEN  :
-                                                                    MAGENTA;
-
-            printf("%s%5d ", color, LITERAL_value(lit));
+            COUNT_STATS_print(&stats);
         }
 
-        printf("\n"RESET);
+        if (ret != UNDEF)
+        {
+            printf("c models ");
+            BIGNUM_print(&count);
+            printf("\n");
+        }
     }
-}
-
-//
-// Literal assertion
-//
-
-void dpll_notify_watches(TRIAL* trial, FORMULA* formula, literal_t literal)
-{
-    // NOTE: literal is the inversion of the asserted literal
-
-    // Get current watch list to work with:
-    WATCHED_STORAGE* ws = WATCH_LIST_get(&trial->wl, literal);
-
-    // Create a new watch list:
-    WATCHED_STORAGE newWS;
-    WATCHED_STORAGE_init(&newWS, CLAUSE_PTR_eq, CLAUSE_PTR_lt, false);
-
-    for (size_t cls_i = 0U; cls_i < ws->size; ++cls_i)
+    else if (options.cube_mode)
     {
-        // Fuck with the type system a bit:
-        CLAUSE* cls = (CLAUSE*)(void*) WATCHED_STORAGE_get(ws, cls_i);
-
-        // Check whether a watched literal is falsified:
-        BUG_ON(CLAUSE_watch1(cls) != literal && CLAUSE_watch2(cls) != literal,
-            "[dpll_notify_watches] Watchlist invariant is broken for clause #%zu",
-            cls_i);
-
-        // Ensure that second literal is falsified:
-        if (CLAUSE_watch1(cls) == literal)
+        JOB_STORAGE cubes;
+        if (options.cubes_in != NULL)
         {
-            CLAUSE_swap_watches(cls);
+            cube_read_file(options.cubes_in, &cubes);
         }
-
-        // At this point:
-        // watch1 = UNDEF/FALSE/TRUE
-        // watch2 = FALSE
-        // Case of  TRUE/FALSE is a true clause => no notification
-        if (TRIAL_literal_is_true(trial, CLAUSE_watch1(cls)))
+        else
         {
-            // Add clause to watch list:
-            WATCHED_STORAGE_push(&newWS, cls);
-
-            continue;
+            ret = cube_generate(&to_solve, options.cube_depth, &cubes, &assignment);
         }
 
-        // At this point:
-        // watch1 = FALSE/UNDEF
-        // watch2 = FALSE
-
-        // Find first non-watched unfalsified literal:
-        bool has_unfalsified = false;
-        for (size_t lit_i = 2U; lit_i < CLAUSE_size(cls); ++lit_i)
+        if (ret == UNDEF && options.cubes_out != NULL)
         {
-            literal_t lit = CLAUSE_get(cls, lit_i);
-            if (!TRIAL_literal_is_false(trial, lit))
-            {
-                // Update watched literal:
-                CLAUSE_set_watch2(cls, lit_i);
-
-                // Add clause to watch list of the new watched literal:
-                // NOTE: this possibly removes the clause from the watch list wl
-                WATCHED_STORAGE* ws_other = WATCH_LIST_get(&trial->wl, lit);
-
-                if (!WATCHED_STORAGE_find(ws_other, cls))
-                {
-                    WATCHED_STORAGE_push(ws_other, cls);
-                }
+            cube_write_file(options.cubes_out, &cubes);
+            printf("c %zu cubes written to %s\n", cubes.size, options.cubes_out);
 
-                has_unfalsified = true;
-                break;
-            }
-        }
+            cube_free_all(&cubes);
+            FORMULA_free(&to_solve);
+            OPTIONS_free(&options);
 
-        if (has_unfalsified)
-        {
-            // Set watches to state:
-            // watch1 = FALSE/UNDEF
-            // watch2 = UNDEF
-            continue;
+            return EXIT_SUCCESS;
         }
 
-        // At this point the clause state is:
-        // watch1 = FALSE/UNDEF
-        // watch2 = FALSE
-        // other  = FALSE
-        if (TRIAL_literal_is_false(trial, CLAUSE_watch1(cls)))
+        if (ret == UNDEF)
         {
-            // Detect a falsified clause:
-            trial->conflict_flag = true;
-
-            // Add clause to watch list:
-            WATCHED_STORAGE_push(&newWS, cls);
+            ret = cube_conquer(&to_solve, &cubes,
+                options.cube_first, options.cube_last, &assignment, num_jobs);
         }
-        else
-        {
-            // Add unit clause to unit-propagation queue:
-            TRIAL_add_to_assertion_queue(trial, CLAUSE_watch1(cls));
 
-            // Add clause to watch list:
-            WATCHED_STORAGE_push(&newWS, cls);
-        }
+        cube_free_all(&cubes);
     }
-
-    // Update watch list:
-    WATCH_LIST_set(&trial->wl, literal, newWS);
-
-    #ifndef NDEBUG
-    printf(YELLOW"[WATCH %d]\n"RESET, LITERAL_value(literal));
-    WATCH_LIST_print(&trial->wl, formula);
-    #endif
-}
-
-void dpll_assert_literal(TRIAL* trial, FORMULA* formula, literal_t literal)
-{
-    // Put decision into the literal:
-    LIT_STORAGE_push(&trial->literals, literal);
-
-    if (literal & LITERAL_DECISION_BIT)
+    else if (options.components)
     {
-        trial->level += 1U;
+        ret = dpll_solve_components(&to_solve, &assignment, num_jobs);
     }
-
-    VARIABLES_assert_literal(&trial->variables,  literal);
-    VARIABLES_remove_literal(&trial->unselected, literal);
-
-    // Ignore the decision bit for the notification:
-    literal &= ~LITERAL_DECISION_BIT;
-
-    dpll_notify_watches(trial, formula, literal ^ LITERAL_CONTRARY_BIT);
-
-    // printf(YELLOW"[ASSERT %3d] "RESET, LITERAL_value(literal));
-    // dpll_print_progress(trial, formula);
-
-    // printf(YELLOW"[NOTIFY %3d] "RESET, -LITERAL_value(literal));
-    // dpll_print_progress(trial, formula);
-}
-
-//
-// Unit propagation
-//
-bool dpll_apply_unit_propagate(TRIAL* trial, FORMULA* formula)
-{
-    if (trial->assertion_queue.size != 0U)
-    {
-        literal_t lit;
-        LIT_STORAGE_pop(&trial->assertion_queue, &lit);
-
-        dpll_assert_literal(trial, formula, lit);
-        return true;
-    }
-
-    return false;
-}
-
-void dpll_exhaustive_unit_propagate(TRIAL* trial, FORMULA* formula)
-{
-    bool ret;
-    do
+    else if (num_jobs > 1U)
     {
-        ret = dpll_apply_unit_propagate(trial, formula);
+        ret = dpll_solve_parallel(&to_solve, &assignment, num_jobs);
     }
-    while (!TRIAL_formula_is_unsat(trial) && ret != false);
-}
-
-//
-// Formula preprocessing
-//
-
-sat_t dpll_preprocess_formula(const FORMULA* initial, FORMULA* resulting, TRIAL* trial)
-{
-    // Initialize the resulting formula:
-    FORMULA_init(resulting);
-
-    for (size_t cls_i = 0U; cls_i < FORMULA_size(initial); cls_i++)
+    else
     {
-        // Clause to be preprocessed:
-        // (Fuck the type system a bit)
-        CLAUSE* clause = FORMULA_get(initial, cls_i);
+        PROGRESS progress;
+        PROGRESS_init(&progress, options.progress_conflicts, options.progress_seconds);
 
-        // Preprocessed clause to be inserted:
-        CLAUSE rslt_clause;
-        CLAUSE_init(&rslt_clause);
+        ARENA arena;
+        ARENA_init(&arena, 0U);
 
-        // Iterate over literals of a clause and copy them to rslt_clause:
-        bool insert_clause = true;
-        for (size_t lit_i = 0U; lit_i < CLAUSE_size(clause); lit_i++)
+        PROOF proof;
+        if (options.proof != NULL && !PROOF_open(&proof, options.proof, options.binary_proof))
         {
-            literal_t cur = CLAUSE_get(clause, lit_i);
+            printf("Unable to open proof file %s\n", options.proof);
 
-            // Do not copy falsified literal:
-            if (TRIAL_literal_is_false(trial, cur))
+            if (keep_input)
             {
-                continue;
-            }
-
-            // Remove already satisfied clause:
-            if (TRIAL_literal_is_true(trial, cur))
-            {
-                insert_clause = false;
-                break;
-            }
-
-            // Handle duplicates and tautology:
-            if (CLAUSE_find(&rslt_clause, cur))
-            {
-                // Detect clause tautology:
-                if (CLAUSE_find(&rslt_clause, cur ^ LITERAL_CONTRARY_BIT))
-                {
-                    // Remove tautological clause:
-                    insert_clause = false;
-                    break;
-                }
-
-                // Do not copy duplicate literals:
-                continue;
+                FORMULA_free(&input);
             }
+            FORMULA_free(&to_solve);
+            OPTIONS_free(&options);
 
-            // Add literal to the clause:
-            CLAUSE_insert(&rslt_clause, cur);
-
-            // Also allow it to be the decision literal in the future:
-            VARIABLES_assert_literal(&trial->unselected, cur);
+            return EXIT_FAILURE;
         }
 
-        // Handle non-inserted clause:
-        if (!insert_clause)
+        // Proof lines are written in the input numbering:
+        if (options.proof != NULL && options.reorder != REORDER_NONE)
         {
-            CLAUSE_free(&rslt_clause);
-            continue;
+            proof.names = renumbering.original;
         }
 
-        // Detect UNSAT:
-        if (CLAUSE_size(&rslt_clause) == 0U)
+        PHASES phases;
+        PHASES_init(&phases, options.flips, options.phase_conflicts, options.seed);
+
+        STATS stats;
+        ret = dpll_solve(&to_solve, &assignment, &stats, &progress,
+            options.phase_search? &phases : NULL, &limits, &arena,
+            (options.proof != NULL)? &proof : NULL);
+
+        if (options.proof != NULL)
         {
-            return UNSAT;
+            PROOF_close(&proof);
         }
 
-        // Assert obvious literal:
-        if (CLAUSE_size(&rslt_clause) == 1U)
+        // The statistics of an abandoned search are always reported:
+        if (options.stats || ret == UNDEF)
         {
-            dpll_assert_literal(trial, resulting, CLAUSE_get(&rslt_clause, 0U));
-            dpll_exhaustive_unit_propagate(trial, resulting);
-
-            continue;
+            STATS_print(&stats);
+            if (options.phase_search)
+            {
+                PHASES_print(&phases);
+            }
+            printf("c arena peak %zu KiB reserved %zu KiB\n", arena.peak / 1024U, arena.reserved / 1024U);
         }
 
-        // NOTE: it is guaranteed that size(rslt_clause) >= 2
-        FORMULA_insert(resulting, rslt_clause);
+        ARENA_free(&arena);
     }
 
-    if (FORMULA_size(resulting) == 0U)
+    if (options.stats || options.mem_limit != 0U)
     {
-        return SAT;
+        printf("c peak RSS %zu KiB\n", MEMORY_peak_rss() / 1024U);
     }
 
-    // Initialize watch list:
-    WATCH_LIST_link_initial(&trial->wl, resulting);
-
-    return UNDEF;
-}
-
-//
-// Branching scheme
-//
-
-literal_t dpll_select_literal(TRIAL* trial, const FORMULA* formula)
-{
-    // Iterate over the formula from least clauses to bigger:
-    literal_t selected = LITERAL_NULL;
-    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    if (ret == SAT && options.reorder != REORDER_NONE)
     {
-        CLAUSE* cls = FORMULA_get(formula, cls_i);
-
-        // Check only the watches:
-        literal_t watch1 = CLAUSE_watch1(cls);
-        literal_t watch2 = CLAUSE_watch2(cls);
-
-        if (TRIAL_literal_is_undef(trial, watch1))
-        {
-            selected = watch1 ^ LITERAL_CONTRARY_BIT;
-            break;
-        }
-
-        if (TRIAL_literal_is_undef(trial, watch2))
-        {
-            selected = watch2 ^ LITERAL_CONTRARY_BIT;
-            break;
-        }
+        VARIABLES renamed = assignment;
+        RENUMBERING_restore(&renumbering, &renamed, &assignment);
     }
 
-    if (selected != LITERAL_NULL)
+    MODEL model;
+    if (ret == SAT)
     {
-        VARIABLES_remove_literal(&trial->unselected, selected);
-        return selected;
+        MODEL_init(&model, &assignment, FORMULA_num_variables(&input));
     }
 
-    return VARIABLES_pop_asserted(&trial->unselected);
-}
-
-void dpll_apply_decide(TRIAL* trial, FORMULA* formula)
-{
-    literal_t branching_literal =
-        dpll_select_literal(trial, formula);
-
-    BUG_ON(branching_literal == LITERAL_NULL,
-        "[%s] Termination not detected\n", "dpll_apply_decide");
-
-    dpll_assert_literal(trial, formula, branching_literal | LITERAL_DECISION_BIT);
-
-    #ifndef NDEBUG
-    printf(YELLOW"[DECIDE %3d] "RESET, LITERAL_value(branching_literal));
-    TRIAL_print(trial);
-    #endif
-}
-
-//
-// Backtracking scheme
-//
-void dpll_apply_backtrack(TRIAL* trial, FORMULA* formula)
-{
-    // Pop everything to last decision literal:
-    literal_t last_decision;
-
-    TRIAL_pop_to_last_decision(trial, &last_decision);
-
-    // Hopefully eliminate conflict:
-    trial->conflict_flag = false;
-
-    // Assert literal with reversed contrarity as non-decision:
-    last_decision ^=  LITERAL_CONTRARY_BIT;
-    last_decision &= ~LITERAL_DECISION_BIT;
-
-    dpll_assert_literal(trial, formula, last_decision);
-}
-
-//
-// General solver algorithm
-//
-sat_t dpll_solve(const FORMULA* initial_formula)
-{
-    // Assertion trial:
-    TRIAL trial;
-    TRIAL_init(&trial, initial_formula->variables.num_literals);
-
-    // Satisfiability status:
-    sat_t sat_flag = UNDEF;
-
-    // Perform initial preprocessing for the formula:
-    // NOTE: it is required to initialize invariants
-    //       for the Two Watch Literal Scheme
-    FORMULA formula;
-
-    sat_flag = dpll_preprocess_formula(initial_formula, &formula, &trial);
-
-    #ifndef NDEBUG
-    printf(YELLOW"[PREPROCESS] "RESET);
-    dpll_print_progress(&trial, &formula);
-    #endif
-
-    // DPLL algorithm:
-    while (sat_flag == UNDEF)
+    if (ret == SAT && options.verify)
     {
-        // Optimize the search by unit propagation:
-        dpll_exhaustive_unit_propagate(&trial, &formula);
-
-        #ifndef NDEBUG
-        printf(YELLOW"[PROPAGATE ] "RESET);
-        dpll_print_progress(&trial, &formula);
-        #endif
-
-        if (TRIAL_formula_is_unsat(&trial))
+        size_t falsified = MODEL_verify(&model, &input);
+        if (falsified != 0U)
         {
-            if (TRIAL_cur_level(&trial) == 0U)
+            // NOTE: the clauses are stored sorted by size, so they are reported by their literals.
+            if (falsified <= FORMULA_size(&input))
             {
-                // Formula is unsatisfiable with no substitutions => UNSAT.
-                sat_flag = UNSAT;
+                const CLAUSE* cls = FORMULA_get(&input, falsified - 1U);
+
+                printf("c model falsifies clause");
+                for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+                {
+                    printf(" %d", LITERAL_value(CLAUSE_get(cls, lit_i)));
+                }
+                printf(" 0\n");
             }
             else
             {
-                // Pop substitution from the trial:
-                dpll_apply_backtrack(&trial, &formula);
+                const CARDINALITY* card = FORMULA_get_cardinality(&input, falsified - 1U - FORMULA_size(&input));
 
-                #ifndef NDEBUG
-                printf(YELLOW"[BACKTRACK ] "RESET);
-                TRIAL_print(&trial);
-                #endif
+                printf("c model falsifies cardinality constraint");
+                for (size_t lit_i = 0U; lit_i < CARDINALITY_size(card); ++lit_i)
+                {
+                    printf(" %d", LITERAL_value(CARDINALITY_get(card, lit_i)));
+                }
+                printf(" <= %zu\n", card->bound);
             }
-        }
-        else
-        {
-            const VARIABLES* formula_vars = &formula.variables;
-            const VARIABLES*   trial_vars = &trial.variables;
 
-            if (VARIABLES_equal(formula_vars, trial_vars))
+            MODEL_free(&model);
+            if (keep_input)
             {
-                // Explicitly get the valuation that satisfies the formula => SAT.
-                sat_flag = SAT;
+                FORMULA_free(&input);
             }
-            else
-            {
-                // Use decision to obtain substitution:
-                dpll_apply_decide(&trial, &formula);
-            }
-        }
-    }
-
-    TRIAL_free(&trial);
+            FORMULA_free(&to_solve);
+            OPTIONS_free(&options);
 
-    return sat_flag;
-}
-
-//=======================//
-// Assembled DPLL-solver //
-//=======================//
+            return EXIT_FAILURE;
+        }
 
-int main(int argc, char* argv[])
-{
-    // Parse input arguments:
-    VERIFY_CONTRACT(argc == 2,
-        "Usage: %s ./path/to/file.cnf\n", argv[0]);
+        printf("c model verified\n");
+    }
 
-    FORMULA to_solve;
-    DIMACS_load_formula(argv[1], &to_solve);
+    printf("%s\n", (ret == SAT)? "SAT" : (ret == UNSAT)? "UNSAT" : "UNKNOWN");
 
-    sat_t ret = dpll_solve(&to_solve);
+    if (ret == SAT)
+    {
+        if (options.model)
+        {
+            MODEL_print(&model);
+        }
 
-    printf("%s\n", ret == SAT? "SAT" : "UNSAT");
+        MODEL_free(&model);
+    }
 
+    if (keep_input)
+    {
+        FORMULA_free(&input);
+    }
     FORMULA_free(&to_solve);
+    OPTIONS_free(&options);
 
-    return EXIT_SUCCESS;
+    return (ret == SAT)? EXIT_SAT : (ret == UNSAT)? EXIT_UNSAT : EXIT_UNKNOWN;
 }
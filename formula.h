@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "utils.h"
 
@@ -52,6 +53,15 @@ int LITERAL_value(literal_t lit)
     return (lit & LITERAL_CONTRARY_BIT)? -value : value;
 }
 
+// Construct literal from its DIMACS value:
+literal_t LITERAL_from_value(int value)
+{
+    literal_t lit = (value < 0)? LITERAL_CONTRARY_BIT : 0U;
+    LITERAL_VALUE_Set(lit, abs(value));
+
+    return lit;
+}
+
 //=======================//
 // Set of used variables //
 //=======================//
@@ -82,6 +92,53 @@ bool VARIABLES_equal(const VARIABLES* a, const VARIABLES* b)
     return a->num_literals == b->num_literals;
 }
 
+// Check that every variable used in subset is also used in set:
+bool VARIABLES_contained(const VARIABLES* subset, const VARIABLES* set)
+{
+    for (uint16_t slot = 0U; slot < NUM_SLOTS; ++slot)
+    {
+        if ((subset->used[slot] & ~set->used[slot]) != 0U)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Largest variable number in the set (zero for an empty set):
+uint16_t VARIABLES_max_value(const VARIABLES* vars)
+{
+    for (uint16_t slot = NUM_SLOTS; slot-- > 0U;)
+    {
+        if (vars->used[slot] != 0U)
+        {
+            for (unsigned subslot = NUM_SUBSLOTS; subslot-- > 0U;)
+            {
+                if (vars->used[slot] & BIT_MASK(subslot))
+                {
+                    return slot * NUM_SUBSLOTS + subslot;
+                }
+            }
+        }
+    }
+
+    return 0U;
+}
+
+// Add every literal of the other set to the set.
+// NOTE: the sets are expected to be disjoint.
+void VARIABLES_merge(VARIABLES* vars, const VARIABLES* other)
+{
+    for (uint16_t slot = 0U; slot < NUM_SLOTS; ++slot)
+    {
+        vars->used[slot]       |= other->used[slot];
+        vars->contrarity[slot] |= other->contrarity[slot];
+    }
+
+    vars->num_literals += other->num_literals;
+}
+
 literal_t VARIABLES_pop_asserted(VARIABLES* vars)
 {
     for (uint16_t slot = 0U; slot < NUM_SLOTS; ++slot)
@@ -236,6 +293,16 @@ void CLAUSE_init(CLAUSE* clause)
         false /*sorted*/);
 }
 
+void CLAUSE_init_arena(CLAUSE* clause, ARENA* arena)
+{
+    LIT_STORAGE_init_arena(
+        &clause->literals,
+        arena,
+        &LITERAL_eq_contrarity,
+        &LITERAL_lt,
+        false /*sorted*/);
+}
+
 void CLAUSE_free(CLAUSE* clause)
 {
     LIT_STORAGE_free(&clause->literals);
@@ -326,6 +393,63 @@ void CLAUSE_swap_watches(CLAUSE* clause)
     LIT_STORAGE_swap(&clause->literals, 0U, 1U);
 }
 
+//=======================================//
+// Cardinality constraint data structure //
+//=======================================//
+
+// At most bound literals of the constraint are true.
+typedef struct
+{
+    LIT_STORAGE literals;
+    size_t bound;
+} CARDINALITY;
+
+void CARDINALITY_init(CARDINALITY* card, size_t bound)
+{
+    LIT_STORAGE_init(
+        &card->literals,
+        &LITERAL_eq_contrarity,
+        &LITERAL_lt,
+        false /*sorted*/);
+
+    card->bound = bound;
+}
+
+void CARDINALITY_free(CARDINALITY* card)
+{
+    LIT_STORAGE_free(&card->literals);
+}
+
+void CARDINALITY_insert(CARDINALITY* card, literal_t element)
+{
+    LIT_STORAGE_push(&card->literals, element);
+}
+
+size_t CARDINALITY_size(const CARDINALITY* card)
+{
+    return card->literals.size;
+}
+
+literal_t CARDINALITY_get(const CARDINALITY* card, size_t index)
+{
+    return LIT_STORAGE_get(&card->literals, index);
+}
+
+bool CARDINALITY_eq(const CARDINALITY* el1, const CARDINALITY* el2)
+{
+    return el1 == el2;
+}
+
+bool CARDINALITY_lt(const CARDINALITY* el1, const CARDINALITY* el2)
+{
+    return CARDINALITY_size(el1) < CARDINALITY_size(el2);
+}
+
+// Parametrize stack with cardinality constraint data type:
+#define DATA_T         CARDINALITY
+#define DATA_STRUCTURE CARDINALITY_STORAGE
+#include "template_stack.h"
+
 //========================//
 // Formula data structure //
 //========================//
@@ -339,8 +463,14 @@ typedef struct
 {
     CLAUSE_STORAGE clauses;
 
+    // Cardinality constraints (only the search of dpll_solve is able to handle them):
+    CARDINALITY_STORAGE cardinalities;
+
     // Variables used in a formula:
     VARIABLES variables;
+
+    // Number of variables declared by the problem line (zero if there is none):
+    size_t num_variables;
 } FORMULA;
 
 void FORMULA_init(FORMULA* formula)
@@ -350,12 +480,52 @@ void FORMULA_init(FORMULA* formula)
         CLAUSE_lt,
         true /*sorted*/);
 
+    CARDINALITY_STORAGE_init(&formula->cardinalities,
+        CARDINALITY_eq,
+        CARDINALITY_lt,
+        false /*sorted*/);
+
     VARIABLES_init(&formula->variables);
+
+    formula->num_variables = 0U;
+}
+
+// Initialize the formula with the clause storage coming from the region.
+// NOTE: the clauses inserted are expected to come from the same region.
+void FORMULA_init_arena(FORMULA* formula, ARENA* arena)
+{
+    CLAUSE_STORAGE_init_arena(&formula->clauses,
+        arena,
+        CLAUSE_eq,
+        CLAUSE_lt,
+        true /*sorted*/);
+
+    CARDINALITY_STORAGE_init_arena(&formula->cardinalities,
+        arena,
+        CARDINALITY_eq,
+        CARDINALITY_lt,
+        false /*sorted*/);
+
+    VARIABLES_init(&formula->variables);
+
+    formula->num_variables = 0U;
 }
 
 void FORMULA_free(FORMULA* formula)
 {
+    for (size_t cls_i = 0U; cls_i < formula->clauses.size; ++cls_i)
+    {
+        CLAUSE_free(&formula->clauses.array[cls_i]);
+    }
+
     CLAUSE_STORAGE_free(&formula->clauses);
+
+    for (size_t card_i = 0U; card_i < formula->cardinalities.size; ++card_i)
+    {
+        CARDINALITY_free(&formula->cardinalities.array[card_i]);
+    }
+
+    CARDINALITY_STORAGE_free(&formula->cardinalities);
 }
 
 void FORMULA_insert(FORMULA* formula, CLAUSE clause)
@@ -370,11 +540,57 @@ void FORMULA_insert(FORMULA* formula, CLAUSE clause)
     }
 }
 
+// Append the clause after the stored ones, so that the stored clauses stay in place
+// (only a reallocation of the storage moves them).
+// NOTE: the clauses are no longer sorted by size.
+void FORMULA_append(FORMULA* formula, CLAUSE clause)
+{
+    formula->clauses.sorted = false;
+    CLAUSE_STORAGE_push(&formula->clauses, clause);
+
+    for (size_t lit_i = 0U; lit_i < CLAUSE_size(&clause); ++lit_i)
+    {
+        literal_t lit = CLAUSE_get(&clause, lit_i);
+
+        VARIABLES_assert_literal(&formula->variables, lit & ~LITERAL_CONTRARY_BIT);
+    }
+}
+
+void FORMULA_insert_cardinality(FORMULA* formula, CARDINALITY card)
+{
+    CARDINALITY_STORAGE_push(&formula->cardinalities, card);
+
+    for (size_t lit_i = 0U; lit_i < CARDINALITY_size(&card); ++lit_i)
+    {
+        literal_t lit = CARDINALITY_get(&card, lit_i);
+
+        VARIABLES_assert_literal(&formula->variables, lit & ~LITERAL_CONTRARY_BIT);
+    }
+}
+
 size_t FORMULA_size(const FORMULA* formula)
 {
     return formula->clauses.size;
 }
 
+// Number of the variables of the formula: the declared ones and the ones used beyond them.
+size_t FORMULA_num_variables(const FORMULA* formula)
+{
+    size_t max_used = VARIABLES_max_value(&formula->variables);
+
+    return (formula->num_variables > max_used)? formula->num_variables : max_used;
+}
+
+size_t FORMULA_num_cardinalities(const FORMULA* formula)
+{
+    return formula->cardinalities.size;
+}
+
+CARDINALITY* FORMULA_get_cardinality(const FORMULA* formula, size_t index)
+{
+    return CARDINALITY_STORAGE_get_ptr(&formula->cardinalities, index);
+}
+
 CLAUSE* FORMULA_get(const FORMULA* formula, size_t index)
 {
     return CLAUSE_STORAGE_get_ptr(&formula->clauses, index);
@@ -0,0 +1,437 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_GENERATOR_H
+#define DPLL_GENERATOR_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "formula.h"
+#include "rng.h"
+
+//=======================//
+// Instance descriptions //
+//=======================//
+
+typedef enum
+{
+    GENERATOR_KSAT,
+    GENERATOR_PIGEONHOLE,
+    GENERATOR_PARITY,
+    GENERATOR_COLORING
+} generator_family_t;
+
+// Maximum clause size of random k-SAT:
+#define GENERATOR_MAX_K 16U
+
+typedef struct
+{
+    generator_family_t family;
+
+    // Random k-SAT with num_clauses = ratio * num_vars:
+    unsigned k;
+    size_t   num_vars;
+    double   ratio;
+
+    // Pigeonhole principle for holes+1 pigeons:
+    size_t holes;
+
+    // Two parity chains over the same variables in different orders:
+    size_t length;
+    bool   unsat;
+
+    // Graph coloring of a random graph:
+    size_t vertices;
+    size_t edges;
+    size_t colors;
+
+    // Size of the resulting formula:
+    size_t num_variables;
+    size_t num_clauses;
+} GENERATOR_SPEC;
+
+// Parse the instance description:
+// - ksat:K:VARS:RATIO      - uniform random K-SAT;
+// - php:HOLES              - pigeonhole formula (UNSAT);
+// - parity:LENGTH[:unsat]  - parity chains (SAT unless unsat is given);
+// - coloring:V:E:COLORS    - COLORS-coloring of a random graph with V vertices and E edges.
+//
+// Return false if the description is invalid.
+bool GENERATOR_SPEC_parse(GENERATOR_SPEC* spec, const char* str)
+{
+    memset(spec, 0, sizeof(GENERATOR_SPEC));
+
+    int end = 0;
+    if (sscanf(str, "ksat:%u:%zu:%lf%n", &spec->k, &spec->num_vars, &spec->ratio, &end) == 3 &&
+        str[end] == '\0')
+    {
+        if (spec->k == 0U || spec->k > GENERATOR_MAX_K ||
+            spec->num_vars < spec->k || spec->ratio <= 0.0)
+        {
+            return false;
+        }
+
+        spec->family        = GENERATOR_KSAT;
+        spec->num_variables = spec->num_vars;
+        spec->num_clauses   = (size_t) (spec->ratio * spec->num_vars + 0.5);
+    }
+    else if (sscanf(str, "php:%zu%n", &spec->holes, &end) == 1 && str[end] == '\0')
+    {
+        if (spec->holes == 0U)
+        {
+            return false;
+        }
+
+        size_t h = spec->holes;
+
+        spec->family        = GENERATOR_PIGEONHOLE;
+        spec->num_variables = (h + 1U) * h;
+        spec->num_clauses   = (h + 1U) + h * (h + 1U) * h / 2U;
+    }
+    else if (sscanf(str, "parity:%zu%n", &spec->length, &end) == 1 &&
+             (str[end] == '\0' || strcmp(str + end, ":unsat") == 0))
+    {
+        if (spec->length < 2U)
+        {
+            return false;
+        }
+
+        size_t n = spec->length;
+
+        spec->family        = GENERATOR_PARITY;
+        spec->unsat         = str[end] != '\0';
+        spec->num_variables = 3U * n - 2U;
+        spec->num_clauses   = 8U * (n - 1U) + 2U;
+    }
+    else if (sscanf(str, "coloring:%zu:%zu:%zu%n",
+                 &spec->vertices, &spec->edges, &spec->colors, &end) == 3 &&
+             str[end] == '\0')
+    {
+        if (spec->vertices < 2U || spec->colors == 0U)
+        {
+            return false;
+        }
+
+        size_t v = spec->vertices;
+        size_t c = spec->colors;
+
+        spec->family        = GENERATOR_COLORING;
+        spec->num_variables = v * c;
+        spec->num_clauses   = v + v * c * (c - 1U) / 2U + spec->edges * c;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+//===================//
+// Generated clauses //
+//===================//
+
+// Clauses are streamed into a DIMACS file and/or an in-memory formula.
+typedef struct
+{
+    FILE*    file;
+    FORMULA* formula;
+
+    size_t num_clauses;
+} GENERATOR_SINK;
+
+void GENERATOR_SINK_clause(GENERATOR_SINK* sink, const int* literals, size_t size)
+{
+    if (sink->file != NULL)
+    {
+        for (size_t lit_i = 0U; lit_i < size; ++lit_i)
+        {
+            fprintf(sink->file, "%d ", literals[lit_i]);
+        }
+
+        fprintf(sink->file, "0\n");
+    }
+
+    if (sink->formula != NULL)
+    {
+        CLAUSE clause;
+        CLAUSE_init(&clause);
+
+        for (size_t lit_i = 0U; lit_i < size; ++lit_i)
+        {
+            CLAUSE_insert(&clause, LITERAL_from_value(literals[lit_i]));
+        }
+
+        FORMULA_insert(sink->formula, clause);
+    }
+
+    sink->num_clauses += 1U;
+}
+
+//
+// Instance families
+//
+
+void generator_ksat(const GENERATOR_SPEC* spec, RNG* rng, GENERATOR_SINK* sink)
+{
+    int literals[GENERATOR_MAX_K];
+
+    for (size_t cls_i = 0U; cls_i < spec->num_clauses; ++cls_i)
+    {
+        // Choose distinct variables:
+        for (unsigned lit_i = 0U; lit_i < spec->k; ++lit_i)
+        {
+            bool distinct;
+            do
+            {
+                literals[lit_i] = 1 + (int) RNG_below(rng, spec->num_vars);
+
+                distinct = true;
+                for (unsigned prev_i = 0U; prev_i < lit_i; ++prev_i)
+                {
+                    distinct = distinct && literals[prev_i] != literals[lit_i];
+                }
+            }
+            while (!distinct);
+        }
+
+        for (unsigned lit_i = 0U; lit_i < spec->k; ++lit_i)
+        {
+            if (RNG_bit(rng))
+            {
+                literals[lit_i] = -literals[lit_i];
+            }
+        }
+
+        GENERATOR_SINK_clause(sink, literals, spec->k);
+    }
+}
+
+void generator_pigeonhole(const GENERATOR_SPEC* spec, GENERATOR_SINK* sink)
+{
+    size_t holes = spec->holes;
+
+    int* literals = calloc(holes, sizeof(int));
+    VERIFY_CONTRACT(literals != NULL,
+        "[%s] Unable to allocate clause of size %zu\n", "generator_pigeonhole", holes);
+
+    // Pigeon p sits in hole h:
+    #define PIGEON_IN_HOLE(p, h) ((int) ((p) * holes + (h) + 1U))
+
+    // Every pigeon sits in some hole:
+    for (size_t pigeon = 0U; pigeon <= holes; ++pigeon)
+    {
+        for (size_t hole = 0U; hole < holes; ++hole)
+        {
+            literals[hole] = PIGEON_IN_HOLE(pigeon, hole);
+        }
+
+        GENERATOR_SINK_clause(sink, literals, holes);
+    }
+
+    // No two pigeons share a hole:
+    for (size_t hole = 0U; hole < holes; ++hole)
+    {
+        for (size_t pigeon1 = 0U; pigeon1 <= holes; ++pigeon1)
+        {
+            for (size_t pigeon2 = pigeon1 + 1U; pigeon2 <= holes; ++pigeon2)
+            {
+                int clause[2U] = {-PIGEON_IN_HOLE(pigeon1, hole), -PIGEON_IN_HOLE(pigeon2, hole)};
+
+                GENERATOR_SINK_clause(sink, clause, 2U);
+            }
+        }
+    }
+
+    #undef PIGEON_IN_HOLE
+
+    free(literals);
+}
+
+// Tseitin encoding of out = in1 XOR in2:
+void generator_xor_gate(GENERATOR_SINK* sink, int out, int in1, int in2)
+{
+    int clauses[4U][3U] =
+    {
+        {-in1, -in2, -out},
+        { in1,  in2, -out},
+        { in1, -in2,  out},
+        {-in1,  in2,  out}
+    };
+
+    for (unsigned cls_i = 0U; cls_i < 4U; ++cls_i)
+    {
+        GENERATOR_SINK_clause(sink, clauses[cls_i], 3U);
+    }
+}
+
+void generator_parity(const GENERATOR_SPEC* spec, RNG* rng, GENERATOR_SINK* sink)
+{
+    size_t n = spec->length;
+
+    // Random order of the variables for the second chain:
+    size_t* order = calloc(n, sizeof(size_t));
+    VERIFY_CONTRACT(order != NULL,
+        "[%s] Unable to allocate permutation of size %zu\n", "generator_parity", n);
+
+    for (size_t i = 0U; i < n; ++i)
+    {
+        order[i] = i;
+    }
+
+    for (size_t i = n - 1U; i > 0U; --i)
+    {
+        size_t j = RNG_below(rng, i + 1U);
+
+        size_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    // Both chains compute the parity of the same variables:
+    bool parity = RNG_bit(rng);
+    bool parities[2U] = {parity, spec->unsat? !parity : parity};
+
+    for (unsigned chain = 0U; chain < 2U; ++chain)
+    {
+        // Variables: x[1..n], chain sums: [n+1, 2n-1] and [2n, 3n-2]:
+        int first_sum = (int) (n + 1U + chain * (n - 1U));
+
+        #define CHAIN_VAR(i) ((int) ((chain == 0U)? (i) : order[i]) + 1)
+
+        generator_xor_gate(sink, first_sum, CHAIN_VAR(0U), CHAIN_VAR(1U));
+
+        for (size_t i = 2U; i < n; ++i)
+        {
+            int sum = first_sum + (int) (i - 1U);
+
+            generator_xor_gate(sink, sum, sum - 1, CHAIN_VAR(i));
+        }
+
+        #undef CHAIN_VAR
+
+        int last_sum = first_sum + (int) (n - 2U);
+        int unit[1U] = {parities[chain]? last_sum : -last_sum};
+
+        GENERATOR_SINK_clause(sink, unit, 1U);
+    }
+
+    free(order);
+}
+
+void generator_coloring(const GENERATOR_SPEC* spec, RNG* rng, GENERATOR_SINK* sink)
+{
+    size_t colors = spec->colors;
+
+    int* literals = calloc(colors, sizeof(int));
+    VERIFY_CONTRACT(literals != NULL,
+        "[%s] Unable to allocate clause of size %zu\n", "generator_coloring", colors);
+
+    // Vertex v has color c:
+    #define VERTEX_COLOR(v, c) ((int) ((v) * colors + (c) + 1U))
+
+    for (size_t vertex = 0U; vertex < spec->vertices; ++vertex)
+    {
+        // At least one color:
+        for (size_t color = 0U; color < colors; ++color)
+        {
+            literals[color] = VERTEX_COLOR(vertex, color);
+        }
+
+        GENERATOR_SINK_clause(sink, literals, colors);
+
+        // At most one color:
+        for (size_t color1 = 0U; color1 < colors; ++color1)
+        {
+            for (size_t color2 = color1 + 1U; color2 < colors; ++color2)
+            {
+                int clause[2U] = {-VERTEX_COLOR(vertex, color1), -VERTEX_COLOR(vertex, color2)};
+
+                GENERATOR_SINK_clause(sink, clause, 2U);
+            }
+        }
+    }
+
+    // Adjacent vertices differ in color:
+    for (size_t edge_i = 0U; edge_i < spec->edges; ++edge_i)
+    {
+        size_t vertex1 = RNG_below(rng, spec->vertices);
+        size_t vertex2 = RNG_below(rng, spec->vertices - 1U);
+        if (vertex2 >= vertex1)
+        {
+            vertex2 += 1U;
+        }
+
+        for (size_t color = 0U; color < colors; ++color)
+        {
+            int clause[2U] = {-VERTEX_COLOR(vertex1, color), -VERTEX_COLOR(vertex2, color)};
+
+            GENERATOR_SINK_clause(sink, clause, 2U);
+        }
+    }
+
+    #undef VERTEX_COLOR
+
+    free(literals);
+}
+
+//=====================//
+// Instance generation //
+//=====================//
+
+// Generate the instance deterministically for the seed.
+void generator_generate(const GENERATOR_SPEC* spec, uint64_t seed, GENERATOR_SINK* sink)
+{
+    RNG rng;
+    RNG_init(&rng, seed);
+
+    sink->num_clauses = 0U;
+
+    switch (spec->family)
+    {
+        case GENERATOR_KSAT:
+            generator_ksat(spec, &rng, sink);
+            break;
+        case GENERATOR_PIGEONHOLE:
+            generator_pigeonhole(spec, sink);
+            break;
+        case GENERATOR_PARITY:
+            generator_parity(spec, &rng, sink);
+            break;
+        case GENERATOR_COLORING:
+            generator_coloring(spec, &rng, sink);
+            break;
+    }
+
+    BUG_ON(sink->num_clauses != spec->num_clauses,
+        "[%s] Generated %zu clauses instead of %zu\n", "generator_generate",
+        sink->num_clauses, spec->num_clauses);
+}
+
+void generator_load_formula(const GENERATOR_SPEC* spec, uint64_t seed, FORMULA* formula)
+{
+    FORMULA_init(formula);
+    formula->num_variables = spec->num_variables;
+
+    GENERATOR_SINK sink = {.file = NULL, .formula = formula};
+    generator_generate(spec, seed, &sink);
+}
+
+void generator_write_dimacs(const GENERATOR_SPEC* spec, uint64_t seed,
+                            const char* description, const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    VERIFY_CONTRACT(file != NULL,
+        "[%s] Unable to open file %s\n", "generator_write_dimacs", filename);
+
+    fprintf(file, "c generated %s seed %"PRIu64"\n", description, seed);
+    fprintf(file, "p cnf %zu %zu\n", spec->num_variables, spec->num_clauses);
+
+    GENERATOR_SINK sink = {.file = file, .formula = NULL};
+    generator_generate(spec, seed, &sink);
+
+    fclose(file);
+}
+
+#endif // DPLL_GENERATOR_H
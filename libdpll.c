@@ -0,0 +1,291 @@
+// No copyright. Vladislav Aleinik, 2023
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "solver.h"
+#include "libdpll.h"
+
+//=============================//
+// Incremental solver instance //
+//=============================//
+
+struct DPLL
+{
+    // Region the formula and the trial come from:
+    ARENA arena;
+
+    // Simplified clauses of the formula:
+    FORMULA formula;
+
+    // Assertion trial (only level-zero literals are kept between calls):
+    TRIAL trial;
+
+    // Watch lists are to be linked again after the clause storage moves:
+    bool relink;
+
+    // Formula is refuted without assumptions:
+    bool inconsistent;
+
+    // Result of the last call:
+    sat_t     status;
+    VARIABLES model;
+
+    // Failed assumptions (indexed by the literal, so that both polarities of a variable may fail):
+    uint8_t failed[SCAN_NUM_VALUES];
+};
+
+DPLL* DPLL_create(void)
+{
+    DPLL* solver = calloc(1U, sizeof(DPLL));
+    VERIFY_CONTRACT(solver != NULL,
+        "[%s] Unable to allocate solver\n", "DPLL_create");
+
+    ARENA_init(&solver->arena, 0U);
+
+    FORMULA_init_arena(&solver->formula, &solver->arena);
+
+    // Variables are not known in advance, so the trial covers all of them:
+    TRIAL_init(&solver->trial, NUM_LITERALS - 1U, &solver->arena);
+
+    solver->relink       = false;
+    solver->inconsistent = false;
+    solver->status       = UNDEF;
+
+    VARIABLES_init(&solver->model);
+
+    return solver;
+}
+
+void DPLL_release(DPLL* solver)
+{
+    // The formula and the trial are released with the region:
+    ARENA_free(&solver->arena);
+
+    free(solver);
+}
+
+// Return to the level-zero trial and propagate the level-zero units.
+void DPLL_restore_level_zero(DPLL* solver)
+{
+    TRIAL* trial = &solver->trial;
+
+    dpll_backtrack_to_level(trial, 0U);
+
+    // Watched clause pointers are invalidated by the reallocation of the clause storage:
+    if (solver->relink)
+    {
+        WATCH_LIST_clear(&trial->wl);
+        WATCH_LIST_link_initial(&trial->wl, &solver->formula);
+
+        solver->relink = false;
+    }
+
+    dpll_exhaustive_unit_propagate(trial, &solver->formula);
+    if (TRIAL_formula_is_unsat(trial))
+    {
+        solver->inconsistent = true;
+    }
+
+    solver->status = UNDEF;
+}
+
+void DPLL_add_clause(DPLL* solver, const int* literals, size_t size)
+{
+    TRIAL* trial = &solver->trial;
+
+    DPLL_restore_level_zero(solver);
+    if (solver->inconsistent)
+    {
+        return;
+    }
+
+    // Simplify the clause by the level-zero trial:
+    CLAUSE clause;
+    CLAUSE_init_arena(&clause, &solver->arena);
+
+    for (size_t lit_i = 0U; lit_i < size; ++lit_i)
+    {
+        VERIFY_CONTRACT(literals[lit_i] != 0 && abs(literals[lit_i]) < (int) NUM_LITERALS,
+            "[DPLL_add_clause] Solver supports literals up to %d (got %d)\n",
+            NUM_LITERALS, literals[lit_i]);
+
+        literal_t lit = LITERAL_from_value(literals[lit_i]);
+
+        if (TRIAL_literal_is_false(trial, lit) || CLAUSE_find(&clause, lit))
+        {
+            continue;
+        }
+
+        if (TRIAL_literal_is_true(trial, lit) ||
+            CLAUSE_find(&clause, lit ^ LITERAL_CONTRARY_BIT))
+        {
+            CLAUSE_free(&clause);
+            return;
+        }
+
+        CLAUSE_insert(&clause, lit);
+    }
+
+    if (CLAUSE_size(&clause) == 0U)
+    {
+        solver->inconsistent = true;
+    }
+    else if (CLAUSE_size(&clause) == 1U)
+    {
+        // Units are propagated through the existing watch lists:
+        dpll_assert_literal(trial, &solver->formula, CLAUSE_get(&clause, 0U));
+        dpll_exhaustive_unit_propagate(trial, &solver->formula);
+
+        if (TRIAL_formula_is_unsat(trial))
+        {
+            solver->inconsistent = true;
+        }
+    }
+    else
+    {
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(&clause); ++lit_i)
+        {
+            VARIABLES_assert_literal(&trial->unselected, CLAUSE_get(&clause, lit_i));
+        }
+
+        // The stored clauses stay in place unless the storage is reallocated:
+        const CLAUSE* storage = solver->formula.clauses.array;
+        FORMULA_append(&solver->formula, clause);
+
+        if (solver->formula.clauses.array != storage)
+        {
+            solver->relink = true;
+        }
+        else if (!solver->relink)
+        {
+            WATCH_LIST_link_clause(&trial->wl,
+                FORMULA_get(&solver->formula, FORMULA_size(&solver->formula) - 1U));
+        }
+
+        return;
+    }
+
+    CLAUSE_free(&clause);
+}
+
+int DPLL_solve(DPLL* solver, const int* assumptions, size_t num_assumptions)
+{
+    TRIAL*   trial   = &solver->trial;
+    FORMULA* formula = &solver->formula;
+
+    memset(solver->failed, 0, sizeof(solver->failed));
+
+    DPLL_restore_level_zero(solver);
+    if (solver->inconsistent)
+    {
+        solver->status = UNSAT;
+        return DPLL_RESULT_UNSAT;
+    }
+
+    // Assumptions are the first decisions of the search:
+    size_t   assumption_i      = 0U;
+    uint32_t assumption_levels = 0U;
+
+    sat_t sat_flag = UNDEF;
+    while (sat_flag == UNDEF)
+    {
+        dpll_exhaustive_unit_propagate(trial, formula);
+
+        if (TRIAL_formula_is_unsat(trial))
+        {
+            trial->stats.conflicts += 1U;
+
+            if (TRIAL_cur_level(trial) == 0U)
+            {
+                solver->inconsistent = true;
+                sat_flag = UNSAT;
+            }
+            else if (TRIAL_cur_level(trial) <= assumption_levels)
+            {
+                // The assumptions decided so far are refuted:
+                for (size_t lit_i = 0U; lit_i < assumption_i; ++lit_i)
+                {
+                    solver->failed[LITERAL_from_value(assumptions[lit_i])] = 1U;
+                }
+
+                sat_flag = UNSAT;
+            }
+            else
+            {
+                dpll_apply_backtrack(trial, formula);
+            }
+        }
+        else if (assumption_i < num_assumptions)
+        {
+            literal_t lit = LITERAL_from_value(assumptions[assumption_i++]);
+
+            if (TRIAL_literal_is_false(trial, lit))
+            {
+                // The assumption is refuted by the previous ones:
+                for (size_t lit_i = 0U; lit_i < assumption_i; ++lit_i)
+                {
+                    solver->failed[LITERAL_from_value(assumptions[lit_i])] = 1U;
+                }
+
+                sat_flag = UNSAT;
+            }
+            else if (TRIAL_literal_is_undef(trial, lit))
+            {
+                dpll_assert_literal(trial, formula, lit | LITERAL_DECISION_BIT);
+                assumption_levels += 1U;
+            }
+        }
+        else if (VARIABLES_contained(&formula->variables, &trial->variables))
+        {
+            solver->model = trial->variables;
+            sat_flag = SAT;
+        }
+        else
+        {
+            dpll_apply_decide(trial, formula);
+        }
+    }
+
+    solver->status = sat_flag;
+
+    return (sat_flag == SAT)? DPLL_RESULT_SAT : DPLL_RESULT_UNSAT;
+}
+
+int DPLL_value(const DPLL* solver, int variable)
+{
+    if (solver->status != SAT || variable <= 0 || variable >= (int) NUM_LITERALS)
+    {
+        return 0;
+    }
+
+    literal_t lit = LITERAL_from_value(variable);
+
+    if (VARIABLES_literal_is_true(&solver->model, lit))
+    {
+        return variable;
+    }
+
+    if (VARIABLES_literal_is_false(&solver->model, lit))
+    {
+        return -variable;
+    }
+
+    return 0;
+}
+
+bool DPLL_failed(const DPLL* solver, int literal)
+{
+    if (solver->status != UNSAT || literal == 0 || abs(literal) >= (int) NUM_LITERALS)
+    {
+        return false;
+    }
+
+    return solver->failed[LITERAL_from_value(literal)] != 0U;
+}
+
+void DPLL_memory(const DPLL* solver, size_t* current, size_t* peak)
+{
+    *current = solver->arena.current;
+    *peak    = solver->arena.peak;
+}
@@ -0,0 +1,51 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_LIBDPLL_H
+#define DPLL_LIBDPLL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+//============================//
+// Incremental solver library //
+//============================//
+
+// Symbols exported from the shared library:
+#define DPLL_API __attribute__((visibility("default")))
+
+// Results of DPLL_solve (same as the exit codes of SAT solvers):
+#define DPLL_RESULT_UNKNOWN  0
+#define DPLL_RESULT_SAT     10
+#define DPLL_RESULT_UNSAT   20
+
+// Opaque solver handle:
+// - The formula, the level-zero trial and the watch lists are kept between calls;
+// - Literals are DIMACS integers (variables up to 2047).
+typedef struct DPLL DPLL;
+
+// Create a solver with an empty formula.
+DPLL_API DPLL* DPLL_create(void);
+
+// Add a clause to the formula.
+DPLL_API void DPLL_add_clause(DPLL* solver, const int* literals, size_t size);
+
+// Solve the formula under assumptions.
+// Assumptions are dropped after the call.
+//
+// Return DPLL_RESULT_SAT or DPLL_RESULT_UNSAT.
+DPLL_API int DPLL_solve(DPLL* solver, const int* assumptions, size_t num_assumptions);
+
+// Value of a variable in the model after DPLL_RESULT_SAT.
+//
+// Return variable if it is true, -variable if it is false, and 0 if it is unassigned.
+DPLL_API int DPLL_value(const DPLL* solver, int variable);
+
+// Check whether the assumption literal took part in the refutation after DPLL_RESULT_UNSAT.
+DPLL_API bool DPLL_failed(const DPLL* solver, int literal);
+
+// Memory held by the formula and the search state (measured in bytes).
+DPLL_API void DPLL_memory(const DPLL* solver, size_t* current, size_t* peak);
+
+// Deallocate the solver.
+DPLL_API void DPLL_release(DPLL* solver);
+
+#endif // DPLL_LIBDPLL_H
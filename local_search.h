@@ -0,0 +1,428 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_LOCAL_SEARCH_H
+#define DPLL_LOCAL_SEARCH_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <signal.h>
+#include <math.h>
+
+#include "utils.h"
+#include "formula.h"
+#include "rng.h"
+#include "bitparallel.h"
+
+//==============================//
+// Stochastic local search data //
+//==============================//
+
+// Break values at or above the cap share the same (negligible) probability:
+#define LOCAL_SEARCH_MAX_BREAK 64U
+
+// Flips between the checks of the time limit and the interruption flag:
+#define LOCAL_SEARCH_CHECK_INTERVAL 65536U
+
+typedef struct
+{
+    size_t num_variables;
+    size_t num_clauses;
+
+    // Clause literals laid out one after another:
+    literal_t* literals;
+    uint32_t*  clause_start;
+
+    // Clauses containing every literal, indexed by 2*var + sign:
+    uint32_t* occurrences;
+    uint32_t* occurrence_start;
+
+    // Current assignment (true or false for every variable):
+    bool* values;
+
+    // Assignment with the fewest falsified clauses seen so far:
+    bool*  best_values;
+    size_t best_unsat;
+
+    // Number of true literals of every clause:
+    uint32_t* num_true;
+
+    // XOR of the variables of true literals
+    // (the only true variable for a clause with a single true literal):
+    uint32_t* critical;
+
+    // Number of clauses that turn false once the variable is flipped:
+    uint32_t* breaks;
+
+    // Indexed set of the falsified clauses:
+    uint32_t* unsat;
+    uint32_t* unsat_index;
+    size_t    num_unsat;
+
+    // Random starting assignments evaluated at once:
+    BITPARALLEL candidates;
+
+    // Selection weight of every break value:
+    double weights[LOCAL_SEARCH_MAX_BREAK];
+
+    RNG rng;
+
+    uint64_t flips;
+} LOCAL_SEARCH;
+
+uint32_t LOCAL_SEARCH_index(literal_t lit)
+{
+    return 2U * LITERAL_VALUE_Get(lit) + ((lit & LITERAL_CONTRARY_BIT) != 0U);
+}
+
+bool LOCAL_SEARCH_literal_is_true(const LOCAL_SEARCH* ls, literal_t lit)
+{
+    return ls->values[LITERAL_VALUE_Get(lit)] == ((lit & LITERAL_CONTRARY_BIT) == 0U);
+}
+
+// Lay out the formula for the search.
+// Duplicate literals are merged and tautologies are dropped.
+//
+// Return false if the formula contains an empty clause.
+bool LOCAL_SEARCH_init(LOCAL_SEARCH* ls, const FORMULA* formula, uint64_t seed)
+{
+    ls->num_variables = VARIABLES_max_value(&formula->variables);
+
+    size_t num_literals = 0U;
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        num_literals += CLAUSE_size(FORMULA_get(formula, cls_i));
+    }
+
+    size_t num_indices = 2U * (ls->num_variables + 1U);
+
+    ls->literals         = malloc(num_literals * sizeof(literal_t) + 1U);
+    ls->clause_start     = malloc((FORMULA_size(formula) + 1U) * sizeof(uint32_t));
+    ls->occurrences      = malloc(num_literals * sizeof(uint32_t) + 1U);
+    ls->occurrence_start = calloc(num_indices + 1U, sizeof(uint32_t));
+    ls->values           = malloc((ls->num_variables + 1U) * sizeof(bool));
+    ls->best_values      = calloc(ls->num_variables + 1U, sizeof(bool));
+    ls->breaks           = calloc(ls->num_variables + 1U, sizeof(uint32_t));
+    VERIFY_CONTRACT(ls->literals != NULL && ls->clause_start != NULL &&
+                    ls->occurrences != NULL && ls->occurrence_start != NULL &&
+                    ls->values != NULL && ls->best_values != NULL && ls->breaks != NULL,
+        "[%s] Unable to allocate search state of %zu literals\n", "LOCAL_SEARCH_init", num_literals);
+
+    // Copy the clauses:
+    bool   empty_clause = false;
+    size_t max_size     = 0U;
+
+    ls->num_clauses = 0U;
+    num_literals    = 0U;
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        size_t start     = num_literals;
+        bool   tautology = false;
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls) && !tautology; ++lit_i)
+        {
+            literal_t lit = CLAUSE_get(cls, lit_i) & ~LITERAL_DECISION_BIT;
+
+            bool duplicate = false;
+            for (size_t prev_i = start; prev_i < num_literals; ++prev_i)
+            {
+                duplicate |= ls->literals[prev_i] == lit;
+                tautology |= ls->literals[prev_i] == (lit ^ LITERAL_CONTRARY_BIT);
+            }
+
+            if (!duplicate)
+            {
+                ls->literals[num_literals++] = lit;
+            }
+        }
+
+        if (tautology)
+        {
+            num_literals = start;
+            continue;
+        }
+
+        empty_clause |= num_literals == start;
+        if (num_literals - start > max_size)
+        {
+            max_size = num_literals - start;
+        }
+
+        ls->clause_start[ls->num_clauses++] = start;
+    }
+
+    ls->clause_start[ls->num_clauses] = num_literals;
+
+    // Counting sort of the clause indices by literal:
+    for (size_t lit_i = 0U; lit_i < num_literals; ++lit_i)
+    {
+        ls->occurrence_start[LOCAL_SEARCH_index(ls->literals[lit_i]) + 1U] += 1U;
+    }
+
+    for (size_t index = 0U; index < num_indices; ++index)
+    {
+        ls->occurrence_start[index + 1U] += ls->occurrence_start[index];
+    }
+
+    for (size_t cls_i = 0U; cls_i < ls->num_clauses; ++cls_i)
+    {
+        for (uint32_t lit_i = ls->clause_start[cls_i]; lit_i < ls->clause_start[cls_i + 1U]; ++lit_i)
+        {
+            uint32_t index = LOCAL_SEARCH_index(ls->literals[lit_i]);
+            ls->occurrences[ls->occurrence_start[index]++] = cls_i;
+        }
+    }
+
+    // Restore the starts shifted by the placement:
+    for (size_t index = num_indices; index > 0U; --index)
+    {
+        ls->occurrence_start[index] = ls->occurrence_start[index - 1U];
+    }
+    ls->occurrence_start[0U] = 0U;
+
+    ls->num_true    = calloc(ls->num_clauses + 1U, sizeof(uint32_t));
+    ls->critical    = calloc(ls->num_clauses + 1U, sizeof(uint32_t));
+    ls->unsat       = malloc((ls->num_clauses + 1U) * sizeof(uint32_t));
+    ls->unsat_index = malloc((ls->num_clauses + 1U) * sizeof(uint32_t));
+    VERIFY_CONTRACT(ls->num_true != NULL && ls->critical != NULL &&
+                    ls->unsat != NULL && ls->unsat_index != NULL,
+        "[%s] Unable to allocate state of %zu clauses\n", "LOCAL_SEARCH_init", ls->num_clauses);
+
+    // probSAT weights: polynomial break function for 3-SAT, exponential for longer clauses.
+    static const double exponential_base[] = {2.5, 2.5, 2.5, 2.5, 3.7, 5.4, 6.4, 7.4};
+    for (unsigned value = 0U; value < LOCAL_SEARCH_MAX_BREAK; ++value)
+    {
+        ls->weights[value] = (max_size <= 3U)?
+            pow(1.0 + value, -2.38) :
+            pow(exponential_base[(max_size < 7U)? max_size : 7U], -(double) value);
+    }
+
+    BITPARALLEL_init(&ls->candidates, formula, 0U);
+
+    RNG_init(&ls->rng, seed);
+
+    ls->num_unsat  = 0U;
+    ls->best_unsat = SIZE_MAX;
+    ls->flips      = 0U;
+
+    return !empty_clause;
+}
+
+void LOCAL_SEARCH_free(LOCAL_SEARCH* ls)
+{
+    free(ls->literals);
+    free(ls->clause_start);
+    free(ls->occurrences);
+    free(ls->occurrence_start);
+    free(ls->values);
+    free(ls->best_values);
+    free(ls->breaks);
+    free(ls->num_true);
+    free(ls->critical);
+    free(ls->unsat);
+    free(ls->unsat_index);
+
+    BITPARALLEL_free(&ls->candidates);
+}
+
+//
+// Incremental state updates
+//
+
+void LOCAL_SEARCH_make_unsat(LOCAL_SEARCH* ls, uint32_t cls_i)
+{
+    ls->unsat_index[cls_i]     = ls->num_unsat;
+    ls->unsat[ls->num_unsat++] = cls_i;
+}
+
+void LOCAL_SEARCH_make_sat(LOCAL_SEARCH* ls, uint32_t cls_i)
+{
+    // Move the last clause into the vacant slot:
+    uint32_t last = ls->unsat[--ls->num_unsat];
+
+    ls->unsat[ls->unsat_index[cls_i]] = last;
+    ls->unsat_index[last]             = ls->unsat_index[cls_i];
+}
+
+// Remember the current assignment if it falsifies fewer clauses than any before.
+void LOCAL_SEARCH_save_best(LOCAL_SEARCH* ls)
+{
+    if (ls->num_unsat < ls->best_unsat)
+    {
+        ls->best_unsat = ls->num_unsat;
+        memcpy(ls->best_values, ls->values, (ls->num_variables + 1U) * sizeof(bool));
+    }
+}
+
+// Recompute the clause states and break values of the current assignment.
+void LOCAL_SEARCH_reset(LOCAL_SEARCH* ls)
+{
+    for (size_t var = 1U; var <= ls->num_variables; ++var)
+    {
+        ls->breaks[var] = 0U;
+    }
+
+    ls->num_unsat = 0U;
+    for (uint32_t cls_i = 0U; cls_i < ls->num_clauses; ++cls_i)
+    {
+        ls->num_true[cls_i] = 0U;
+        ls->critical[cls_i] = 0U;
+
+        for (uint32_t lit_i = ls->clause_start[cls_i]; lit_i < ls->clause_start[cls_i + 1U]; ++lit_i)
+        {
+            literal_t lit = ls->literals[lit_i];
+            if (LOCAL_SEARCH_literal_is_true(ls, lit))
+            {
+                ls->num_true[cls_i] += 1U;
+                ls->critical[cls_i] ^= LITERAL_VALUE_Get(lit);
+            }
+        }
+
+        if (ls->num_true[cls_i] == 0U)
+        {
+            LOCAL_SEARCH_make_unsat(ls, cls_i);
+        }
+        else if (ls->num_true[cls_i] == 1U)
+        {
+            ls->breaks[ls->critical[cls_i]] += 1U;
+        }
+    }
+
+    LOCAL_SEARCH_save_best(ls);
+}
+
+// Start from the best of a vector of random assignments.
+void LOCAL_SEARCH_randomize(LOCAL_SEARCH* ls)
+{
+    BITPARALLEL_randomize(&ls->candidates, &ls->rng);
+
+    uint32_t unsat[64U * BITPARALLEL_MAX_WORDS];
+    BITPARALLEL_evaluate(&ls->candidates, unsat);
+
+    size_t best_lane = 0U;
+    for (size_t lane = 1U; lane < BITPARALLEL_num_lanes(&ls->candidates); ++lane)
+    {
+        if (unsat[lane] < unsat[best_lane])
+        {
+            best_lane = lane;
+        }
+    }
+
+    for (size_t var = 1U; var <= ls->num_variables; ++var)
+    {
+        ls->values[var] = BITPARALLEL_get(&ls->candidates, var, best_lane);
+    }
+
+    LOCAL_SEARCH_reset(ls);
+}
+
+// Continue from the best assignment seen so far.
+void LOCAL_SEARCH_restore_best(LOCAL_SEARCH* ls)
+{
+    memcpy(ls->values, ls->best_values, (ls->num_variables + 1U) * sizeof(bool));
+
+    LOCAL_SEARCH_reset(ls);
+}
+
+void LOCAL_SEARCH_flip(LOCAL_SEARCH* ls, uint32_t var)
+{
+    ls->values[var] = !ls->values[var];
+    ls->flips += 1U;
+
+    uint32_t made_true  = 2U * var + !ls->values[var];
+    uint32_t made_false = made_true ^ 1U;
+
+    for (uint32_t occ_i = ls->occurrence_start[made_true]; occ_i < ls->occurrence_start[made_true + 1U]; ++occ_i)
+    {
+        uint32_t cls_i = ls->occurrences[occ_i];
+
+        ls->num_true[cls_i] += 1U;
+        if (ls->num_true[cls_i] == 1U)
+        {
+            LOCAL_SEARCH_make_sat(ls, cls_i);
+            ls->breaks[var] += 1U;
+        }
+        else if (ls->num_true[cls_i] == 2U)
+        {
+            // The former critical variable may now be flipped freely:
+            ls->breaks[ls->critical[cls_i]] -= 1U;
+        }
+
+        ls->critical[cls_i] ^= var;
+    }
+
+    for (uint32_t occ_i = ls->occurrence_start[made_false]; occ_i < ls->occurrence_start[made_false + 1U]; ++occ_i)
+    {
+        uint32_t cls_i = ls->occurrences[occ_i];
+
+        ls->num_true[cls_i] -= 1U;
+        ls->critical[cls_i] ^= var;
+
+        if (ls->num_true[cls_i] == 0U)
+        {
+            LOCAL_SEARCH_make_unsat(ls, cls_i);
+            ls->breaks[var] -= 1U;
+        }
+        else if (ls->num_true[cls_i] == 1U)
+        {
+            ls->breaks[ls->critical[cls_i]] += 1U;
+        }
+    }
+}
+
+// Pick a variable of a random falsified clause with the probability decreasing with its break value.
+uint32_t LOCAL_SEARCH_pick(LOCAL_SEARCH* ls)
+{
+    uint32_t cls_i = ls->unsat[RNG_below(&ls->rng, ls->num_unsat)];
+
+    uint32_t first = ls->clause_start[cls_i];
+    uint32_t last  = ls->clause_start[cls_i + 1U];
+
+    double sum = 0.0;
+    for (uint32_t lit_i = first; lit_i < last; ++lit_i)
+    {
+        uint32_t value = ls->breaks[LITERAL_VALUE_Get(ls->literals[lit_i])];
+        sum += ls->weights[(value < LOCAL_SEARCH_MAX_BREAK)? value : LOCAL_SEARCH_MAX_BREAK - 1U];
+    }
+
+    double threshold = sum * RNG_real(&ls->rng);
+    for (uint32_t lit_i = first; lit_i + 1U < last; ++lit_i)
+    {
+        uint32_t value = ls->breaks[LITERAL_VALUE_Get(ls->literals[lit_i])];
+
+        threshold -= ls->weights[(value < LOCAL_SEARCH_MAX_BREAK)? value : LOCAL_SEARCH_MAX_BREAK - 1U];
+        if (threshold < 0.0)
+        {
+            return LITERAL_VALUE_Get(ls->literals[lit_i]);
+        }
+    }
+
+    return LITERAL_VALUE_Get(ls->literals[last - 1U]);
+}
+
+// Perform at most max_flips flips (zero for no flip limit).
+// The search stops early once the flag is raised (if not NULL) or the deadline passes (if not zero).
+//
+// Return true if the current assignment satisfies the formula.
+bool LOCAL_SEARCH_run(LOCAL_SEARCH* ls, uint64_t max_flips, volatile sig_atomic_t* interrupted, double deadline)
+{
+    uint64_t last_flip = ls->flips + max_flips;
+
+    while (ls->num_unsat != 0U && (max_flips == 0U || ls->flips < last_flip))
+    {
+        if (ls->flips % LOCAL_SEARCH_CHECK_INTERVAL == LOCAL_SEARCH_CHECK_INTERVAL - 1U &&
+            ((interrupted != NULL && *interrupted) || (deadline != 0.0 && TIME_now() >= deadline)))
+        {
+            break;
+        }
+
+        LOCAL_SEARCH_flip(ls, LOCAL_SEARCH_pick(ls));
+        LOCAL_SEARCH_save_best(ls);
+    }
+
+    return ls->num_unsat == 0U;
+}
+
+#endif // DPLL_LOCAL_SEARCH_H
@@ -0,0 +1,107 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_MEMORY_H
+#define DPLL_MEMORY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+//===================//
+// Memory accounting //
+//===================//
+
+typedef enum
+{
+    MEMORY_CLAUSES,
+    MEMORY_WATCHES,
+    MEMORY_TRAIL,
+    MEMORY_OCCURRENCES,
+
+    MEMORY_NUM_TAGS
+} memory_tag_t;
+
+const char* MEMORY_NAMES[MEMORY_NUM_TAGS] =
+{
+    [MEMORY_CLAUSES]     = "clauses",
+    [MEMORY_WATCHES]     = "watches",
+    [MEMORY_TRAIL]       = "trail",
+    [MEMORY_OCCURRENCES] = "occurrences"
+};
+
+// Bytes held by every solver subsystem:
+typedef struct
+{
+    size_t bytes[MEMORY_NUM_TAGS];
+} MEMORY_USAGE;
+
+void MEMORY_USAGE_init(MEMORY_USAGE* usage)
+{
+    for (unsigned tag = 0U; tag < MEMORY_NUM_TAGS; ++tag)
+    {
+        usage->bytes[tag] = 0U;
+    }
+}
+
+size_t MEMORY_USAGE_total(const MEMORY_USAGE* usage)
+{
+    size_t total = 0U;
+    for (unsigned tag = 0U; tag < MEMORY_NUM_TAGS; ++tag)
+    {
+        total += usage->bytes[tag];
+    }
+
+    return total;
+}
+
+void MEMORY_USAGE_print(const MEMORY_USAGE* usage)
+{
+    printf("c memory");
+
+    for (unsigned tag = 0U; tag < MEMORY_NUM_TAGS; ++tag)
+    {
+        printf(" %s %zu", MEMORY_NAMES[tag], usage->bytes[tag] / 1024U);
+    }
+
+    printf(" total %zu KiB\n", MEMORY_USAGE_total(usage) / 1024U);
+}
+
+//=========================//
+// Process resident memory //
+//=========================//
+
+// Current resident set size (measured in bytes).
+size_t MEMORY_rss(void)
+{
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == NULL)
+    {
+        return 0U;
+    }
+
+    unsigned long long total_pages = 0U, resident_pages = 0U;
+    int ret = fscanf(statm, "%llu %llu", &total_pages, &resident_pages);
+
+    fclose(statm);
+
+    if (ret != 2)
+    {
+        return 0U;
+    }
+
+    return resident_pages * sysconf(_SC_PAGESIZE);
+}
+
+// Peak resident set size (measured in bytes).
+size_t MEMORY_peak_rss(void)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0U;
+    }
+
+    return 1024U * (size_t) usage.ru_maxrss;
+}
+
+#endif // DPLL_MEMORY_H
@@ -0,0 +1,556 @@
+// No copyright. Vladislav Aleinik, 2023
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "alloc_count.h"
+#include "solver.h"
+
+//================================//
+// Core data structure benchmarks //
+//================================//
+
+// Keep the results alive for the optimizer:
+volatile size_t microbench_sink;
+
+uint64_t microbench_rng_state = 0x9E3779B97F4A7C15U;
+
+uint32_t microbench_random(void)
+{
+    // Xorshift64:
+    microbench_rng_state ^= microbench_rng_state << 13U;
+    microbench_rng_state ^= microbench_rng_state >> 7U;
+    microbench_rng_state ^= microbench_rng_state << 17U;
+
+    return microbench_rng_state >> 32U;
+}
+
+literal_t microbench_random_literal(uint16_t num_vars)
+{
+    literal_t lit = (microbench_random() & 1U)? LITERAL_CONTRARY_BIT : 0U;
+    LITERAL_VALUE_Set(lit, 1U + microbench_random() % num_vars);
+
+    return lit;
+}
+
+// Benchmark performs the operations and returns their number.
+typedef size_t (*microbench_t)(size_t scale);
+
+//
+// Stacks
+//
+
+size_t microbench_lit_push_pop(size_t scale)
+{
+    size_t ops = 0U;
+    while (ops < scale)
+    {
+        LIT_STORAGE stack;
+        LIT_STORAGE_init(&stack, LITERAL_eq_contrarity, LITERAL_lt, false);
+
+        for (literal_t lit = 1U; lit <= 1024U; ++lit)
+        {
+            LIT_STORAGE_push(&stack, lit);
+        }
+
+        literal_t lit;
+        while (LIT_STORAGE_pop(&stack, &lit))
+        {
+            microbench_sink += lit;
+        }
+
+        LIT_STORAGE_free(&stack);
+
+        ops += 2U * 1024U;
+    }
+
+    return ops;
+}
+
+size_t microbench_lit_find(size_t scale)
+{
+    // Size of a long clause:
+    LIT_STORAGE stack;
+    LIT_STORAGE_init(&stack, LITERAL_eq_contrarity, LITERAL_lt, false);
+
+    for (size_t lit_i = 0U; lit_i < 64U; ++lit_i)
+    {
+        LIT_STORAGE_push(&stack, microbench_random_literal(128U));
+    }
+
+    for (size_t op = 0U; op < scale; ++op)
+    {
+        microbench_sink += LIT_STORAGE_find(&stack, microbench_random_literal(128U));
+    }
+
+    LIT_STORAGE_free(&stack);
+
+    return scale;
+}
+
+size_t microbench_lit_queue(size_t scale)
+{
+    // Usage pattern of the assertion queue:
+    LIT_STORAGE queue;
+    LIT_STORAGE_init(&queue, LITERAL_eq_contrarity, LITERAL_lt, false);
+
+    size_t ops = 0U;
+    while (ops < scale)
+    {
+        for (size_t lit_i = 0U; lit_i < 16U; ++lit_i)
+        {
+            LIT_STORAGE_insert(&queue, microbench_random_literal(1024U), 0U);
+        }
+
+        literal_t lit;
+        while (LIT_STORAGE_pop(&queue, &lit))
+        {
+            microbench_sink += lit;
+        }
+
+        ops += 2U * 16U;
+    }
+
+    LIT_STORAGE_free(&queue);
+
+    return ops;
+}
+
+size_t microbench_lit_sorted(size_t scale)
+{
+    size_t ops = 0U;
+    while (ops < scale)
+    {
+        LIT_STORAGE stack;
+        LIT_STORAGE_init(&stack, LITERAL_eq_value, LITERAL_lt, true /*sorted*/);
+
+        for (size_t lit_i = 0U; lit_i < 256U; ++lit_i)
+        {
+            LIT_STORAGE_insert_sorted(&stack, microbench_random_literal(1024U));
+        }
+
+        for (size_t lit_i = 0U; lit_i < 256U; ++lit_i)
+        {
+            microbench_sink += LIT_STORAGE_find_sorted(&stack, microbench_random_literal(1024U));
+        }
+
+        LIT_STORAGE_free(&stack);
+
+        ops += 2U * 256U;
+    }
+
+    return ops;
+}
+
+size_t microbench_watched_find_push(size_t scale)
+{
+    CLAUSE clauses[64U];
+
+    size_t ops = 0U;
+    while (ops < scale)
+    {
+        // Usage pattern of the watch notification:
+        WATCHED_STORAGE ws;
+        WATCHED_STORAGE_init(&ws, CLAUSE_PTR_eq, CLAUSE_PTR_lt, false);
+
+        for (size_t cls_i = 0U; cls_i < 64U; ++cls_i)
+        {
+            const CLAUSE* cls = &clauses[microbench_random() % 64U];
+
+            if (!WATCHED_STORAGE_find(&ws, cls))
+            {
+                WATCHED_STORAGE_push(&ws, cls);
+            }
+        }
+
+        microbench_sink += ws.size;
+
+        WATCHED_STORAGE_free(&ws);
+
+        ops += 64U;
+    }
+
+    return ops;
+}
+
+//
+// Variable sets
+//
+
+size_t microbench_variables_assert_remove(size_t scale)
+{
+    VARIABLES vars;
+    VARIABLES_init(&vars);
+
+    for (size_t op = 0U; op < scale; op += 2U)
+    {
+        literal_t lit = microbench_random_literal(NUM_LITERALS - 1U);
+
+        VARIABLES_assert_literal(&vars, lit);
+        microbench_sink += VARIABLES_literal_is_true(&vars, lit);
+        VARIABLES_remove_literal(&vars, lit);
+    }
+
+    return scale;
+}
+
+size_t microbench_variables_pop_asserted(size_t scale)
+{
+    VARIABLES vars;
+
+    size_t ops = 0U;
+    while (ops < scale)
+    {
+        VARIABLES_init(&vars);
+
+        for (uint16_t var = 1U; var < NUM_LITERALS; ++var)
+        {
+            literal_t lit = 0U;
+            LITERAL_VALUE_Set(lit, var);
+
+            VARIABLES_assert_literal(&vars, lit);
+        }
+
+        literal_t lit;
+        while ((lit = VARIABLES_pop_asserted(&vars)) != LITERAL_NULL)
+        {
+            microbench_sink += lit;
+            ops += 1U;
+        }
+    }
+
+    return ops;
+}
+
+//
+// Watch lists
+//
+
+#define MICROBENCH_NUM_VARS    200U
+#define MICROBENCH_NUM_CLAUSES 800U
+
+// Random 3-SAT formula under the phase transition ratio:
+void microbench_random_formula(FORMULA* formula)
+{
+    FORMULA_init(formula);
+
+    for (size_t cls_i = 0U; cls_i < MICROBENCH_NUM_CLAUSES; ++cls_i)
+    {
+        CLAUSE clause;
+        CLAUSE_init(&clause);
+
+        while (CLAUSE_size(&clause) < 3U)
+        {
+            literal_t lit = microbench_random_literal(MICROBENCH_NUM_VARS);
+            if (!CLAUSE_find(&clause, lit) && !CLAUSE_find(&clause, lit ^ LITERAL_CONTRARY_BIT))
+            {
+                CLAUSE_insert(&clause, lit);
+            }
+        }
+
+        FORMULA_insert(formula, clause);
+    }
+}
+
+size_t microbench_watch_traversal(size_t scale)
+{
+    FORMULA initial, formula;
+    microbench_random_formula(&initial);
+
+    TRIAL trial;
+    sat_t sat_flag = dpll_init_search(&initial, &formula, &trial, NULL, NULL, 0U);
+
+    // Descend by random decisions until a conflict and start over:
+    while (sat_flag == UNDEF && trial.stats.watch_visits < scale)
+    {
+        literal_t lit = microbench_random_literal(MICROBENCH_NUM_VARS);
+        if (TRIAL_literal_is_undef(&trial, lit))
+        {
+            dpll_assert_literal(&trial, &formula, lit | LITERAL_DECISION_BIT);
+            dpll_exhaustive_unit_propagate(&trial, &formula);
+        }
+
+        if (TRIAL_formula_is_unsat(&trial) ||
+            VARIABLES_contained(&formula.variables, &trial.variables))
+        {
+            dpll_backtrack_to_level(&trial, 0U);
+        }
+    }
+
+    size_t ops = trial.stats.watch_visits;
+
+    FORMULA_free(&initial);
+    FORMULA_free(&formula);
+    TRIAL_free(&trial);
+
+    return ops;
+}
+
+//
+// Bit-parallel evaluation
+//
+
+// Evaluate random assignments in vectors of the given width (clamped to the widest supported).
+size_t microbench_bitparallel(size_t scale, unsigned num_words)
+{
+    FORMULA formula;
+    microbench_random_formula(&formula);
+
+    BITPARALLEL bp;
+    BITPARALLEL_init(&bp, &formula, num_words);
+
+    RNG rng;
+    RNG_init(&rng, 1U);
+
+    uint32_t unsat[64U * BITPARALLEL_MAX_WORDS];
+
+    // Operation is the evaluation of a clause in a lane:
+    size_t ops = 0U;
+    while (ops < scale)
+    {
+        BITPARALLEL_randomize(&bp, &rng);
+        BITPARALLEL_evaluate(&bp, unsat);
+
+        microbench_sink += unsat[0U];
+        ops += FORMULA_size(&formula) * BITPARALLEL_num_lanes(&bp);
+    }
+
+    BITPARALLEL_free(&bp);
+    FORMULA_free(&formula);
+
+    return ops;
+}
+
+size_t microbench_bitparallel_64(size_t scale)
+{
+    return microbench_bitparallel(scale, 1U);
+}
+
+size_t microbench_bitparallel_256(size_t scale)
+{
+    return microbench_bitparallel(scale, 4U);
+}
+
+size_t microbench_bitparallel_512(size_t scale)
+{
+    return microbench_bitparallel(scale, 8U);
+}
+
+//
+// Replacement watch search
+//
+
+#define MICROBENCH_SCAN_CLAUSES 64U
+#define MICROBENCH_SCAN_LENGTH  256U
+
+// Search long clauses, whose first unfalsified literal is at a random position.
+size_t microbench_scan(size_t scale, scan_kernel_t kernel)
+{
+    uint8_t* falsified = calloc(SCAN_NUM_VALUES + SCAN_VALUES_PADDING, sizeof(uint8_t));
+    literal_t* clauses = malloc(MICROBENCH_SCAN_CLAUSES * MICROBENCH_SCAN_LENGTH * sizeof(literal_t));
+
+    // Every literal is false except for the ones of the last variable:
+    for (literal_t lit = 1U; lit < NUM_LITERALS - 1U; ++lit)
+    {
+        falsified[lit] = 1U;
+        falsified[lit | LITERAL_CONTRARY_BIT] = 1U;
+    }
+
+    for (size_t cls_i = 0U; cls_i < MICROBENCH_SCAN_CLAUSES; ++cls_i)
+    {
+        literal_t* clause = clauses + cls_i * MICROBENCH_SCAN_LENGTH;
+        for (size_t lit_i = 0U; lit_i < MICROBENCH_SCAN_LENGTH; ++lit_i)
+        {
+            clause[lit_i] = microbench_random_literal(NUM_LITERALS - 2U);
+        }
+
+        LITERAL_VALUE_Set(clause[microbench_random() % MICROBENCH_SCAN_LENGTH], NUM_LITERALS - 1U);
+    }
+
+    // Operation is a literal inspected:
+    size_t ops = 0U;
+    while (ops < scale)
+    {
+        for (size_t cls_i = 0U; cls_i < MICROBENCH_SCAN_CLAUSES; ++cls_i)
+        {
+            size_t found = kernel(clauses + cls_i * MICROBENCH_SCAN_LENGTH, 0U, MICROBENCH_SCAN_LENGTH, falsified);
+
+            microbench_sink += found;
+            ops += found + 1U;
+        }
+    }
+
+    free(falsified);
+    free(clauses);
+
+    return ops;
+}
+
+size_t microbench_scan_scalar(size_t scale)
+{
+    return microbench_scan(scale, SCAN_scalar);
+}
+
+size_t microbench_scan_dispatched(size_t scale)
+{
+    SCAN_init();
+
+    return microbench_scan(scale, SCAN_kernel);
+}
+
+//==================//
+// Benchmark driver //
+//==================//
+
+typedef struct
+{
+    const char*  name;
+    microbench_t run;
+} MICROBENCH;
+
+const MICROBENCH MICROBENCHES[] =
+{
+    {"LIT_STORAGE push/pop",            microbench_lit_push_pop},
+    {"LIT_STORAGE find",                microbench_lit_find},
+    {"LIT_STORAGE insert/pop queue",    microbench_lit_queue},
+    {"LIT_STORAGE insert/find sorted",  microbench_lit_sorted},
+    {"WATCHED_STORAGE find/push",       microbench_watched_find_push},
+    {"VARIABLES assert/remove",         microbench_variables_assert_remove},
+    {"VARIABLES pop_asserted",          microbench_variables_pop_asserted},
+    {"WATCH_LIST traversal",            microbench_watch_traversal},
+    {"BITPARALLEL evaluate 64",         microbench_bitparallel_64},
+    {"BITPARALLEL evaluate 256",        microbench_bitparallel_256},
+    {"BITPARALLEL evaluate 512",        microbench_bitparallel_512},
+    {"SCAN long clauses scalar",        microbench_scan_scalar},
+    {"SCAN long clauses dispatched",    microbench_scan_dispatched}
+};
+
+void microbench_usage(const char* program)
+{
+    printf("Usage: %s [options] [benchmark name substring]...\n", program);
+    printf("Options:\n");
+    printf("  --scale N   perform about N operations per measurement (default: 1000000)\n");
+    printf("  --repeat N  report the best of N measurements (default: 5)\n");
+    printf("  --csv       print the results as CSV\n");
+
+    exit(EXIT_FAILURE);
+}
+
+size_t microbench_read_number(int argc, char* argv[], int* arg_i)
+{
+    if (*arg_i + 1 >= argc)
+    {
+        microbench_usage(argv[0]);
+    }
+
+    *arg_i += 1;
+
+    char* endptr = NULL;
+    unsigned long long value = strtoull(argv[*arg_i], &endptr, 10);
+    if (endptr == argv[*arg_i] || *endptr != '\0' || value == 0U)
+    {
+        microbench_usage(argv[0]);
+    }
+
+    return value;
+}
+
+bool microbench_selected(const char* name, int argc, char* argv[], int first_name)
+{
+    if (first_name == argc)
+    {
+        return true;
+    }
+
+    for (int arg_i = first_name; arg_i < argc; ++arg_i)
+    {
+        if (strstr(name, argv[arg_i]) != NULL)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t scale  = 1000000U;
+    size_t repeat = 5U;
+    bool   csv    = false;
+
+    int arg_i = 1;
+    for (; arg_i < argc && argv[arg_i][0] == '-'; ++arg_i)
+    {
+        if (strcmp(argv[arg_i], "--scale") == 0)
+        {
+            scale = microbench_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(argv[arg_i], "--repeat") == 0)
+        {
+            repeat = microbench_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(argv[arg_i], "--csv") == 0)
+        {
+            csv = true;
+        }
+        else
+        {
+            microbench_usage(argv[0]);
+        }
+    }
+
+    if (csv)
+    {
+        printf("benchmark,ops,ns_per_op,allocs_per_op\n");
+    }
+    else
+    {
+        printf("%-32s %12s %12s %14s\n", "benchmark", "ops", "ns/op", "allocs/op");
+    }
+
+    size_t num_benches = sizeof(MICROBENCHES) / sizeof(MICROBENCHES[0U]);
+    for (size_t bench_i = 0U; bench_i < num_benches; ++bench_i)
+    {
+        const MICROBENCH* bench = &MICROBENCHES[bench_i];
+        if (!microbench_selected(bench->name, argc, argv, arg_i))
+        {
+            continue;
+        }
+
+        // Report the least disturbed measurement:
+        double best_ns = 0.0;
+        double allocs  = 0.0;
+        size_t ops     = 0U;
+        for (size_t run = 0U; run < repeat; ++run)
+        {
+            ALLOC_COUNTERS before = ALLOC_COUNTERS_get();
+            double start = TIME_now();
+
+            ops = bench->run(scale);
+
+            double elapsed = TIME_now() - start;
+            ALLOC_COUNTERS after = ALLOC_COUNTERS_get();
+
+            double ns = 1e9 * elapsed / ops;
+            if (run == 0U || ns < best_ns)
+            {
+                best_ns = ns;
+            }
+
+            allocs = (double) (after.allocations - before.allocations) / ops;
+        }
+
+        if (csv)
+        {
+            printf("%s,%zu,%.3f,%.4f\n", bench->name, ops, best_ns, allocs);
+        }
+        else
+        {
+            printf("%-32s %12zu %12.3f %14.4f\n", bench->name, ops, best_ns, allocs);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_MODEL_H
+#define DPLL_MODEL_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "formula.h"
+
+//======================//
+// Complete assignments //
+//======================//
+
+// Value of every variable 1..num_variables.
+typedef struct
+{
+    // Zero if the variable is true, LITERAL_CONTRARY_BIT if it is false:
+    literal_t* values;
+    size_t num_variables;
+} MODEL;
+
+// Complete the assignment found by the search.
+// NOTE: the search stops as soon as every clause is satisfied,
+//       so the unassigned variables are free and are set to false.
+void MODEL_init(MODEL* model, const VARIABLES* assignment, size_t num_variables)
+{
+    model->num_variables = num_variables;
+    model->values        = calloc(num_variables + 1U, sizeof(literal_t));
+    VERIFY_CONTRACT(model->values != NULL,
+        "[%s] Unable to allocate model of %zu variables\n", "MODEL_init", num_variables);
+
+    for (size_t var = 1U; var <= num_variables; ++var)
+    {
+        literal_t positive = 0U;
+        LITERAL_VALUE_Set(positive, var);
+
+        bool value = VARIABLES_literal_is_true(assignment, positive);
+
+        model->values[var] = value? 0U : LITERAL_CONTRARY_BIT;
+    }
+}
+
+void MODEL_free(MODEL* model)
+{
+    free(model->values);
+}
+
+bool MODEL_literal_is_true(const MODEL* model, literal_t lit)
+{
+    return model->values[LITERAL_VALUE_Get(lit)] == (lit & LITERAL_CONTRARY_BIT);
+}
+
+// Print the model as SAT competition value lines.
+void MODEL_print(const MODEL* model)
+{
+    // Keep the lines short:
+    int line_length = printf("v");
+
+    for (size_t var = 1U; var <= model->num_variables; ++var)
+    {
+        if (line_length > 72)
+        {
+            printf("\nv");
+            line_length = 1;
+        }
+
+        int value = (model->values[var] == 0U)? (int) var : -(int) var;
+        line_length += printf(" %d", value);
+    }
+
+    printf(" 0\n");
+}
+
+//====================//
+// Model verification //
+//====================//
+
+// Check the model against every clause and cardinality constraint of the formula.
+// The formula is flattened into a single literal array
+// with LITERAL_NULL terminating every clause, then scanned once.
+//
+// Return the storage index of the first falsified constraint plus one or zero if the model is correct.
+size_t MODEL_verify(const MODEL* model, const FORMULA* formula)
+{
+    size_t num_literals = 0U;
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        num_literals += CLAUSE_size(FORMULA_get(formula, cls_i)) + 1U;
+    }
+
+    literal_t* flat = malloc((num_literals + 1U) * sizeof(literal_t));
+    VERIFY_CONTRACT(flat != NULL,
+        "[%s] Unable to allocate %zu literals\n", "MODEL_verify", num_literals);
+
+    literal_t* end = flat;
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        memcpy(end, cls->literals.array, CLAUSE_size(cls) * sizeof(literal_t));
+        end += CLAUSE_size(cls);
+
+        *end++ = LITERAL_NULL;
+    }
+
+    // Variables beyond the model are false:
+    size_t falsified = 0U;
+    size_t cls_i     = 0U;
+    bool   satisfied = false;
+    for (const literal_t* lit = flat; lit != end; ++lit)
+    {
+        if (*lit == LITERAL_NULL)
+        {
+            if (!satisfied)
+            {
+                falsified = cls_i + 1U;
+                break;
+            }
+
+            cls_i    += 1U;
+            satisfied = false;
+            continue;
+        }
+
+        if (LITERAL_VALUE_Get(*lit) > model->num_variables)
+        {
+            satisfied |= (*lit & LITERAL_CONTRARY_BIT) != 0U;
+        }
+        else
+        {
+            satisfied |= MODEL_literal_is_true(model, *lit);
+        }
+    }
+
+    free(flat);
+
+    if (falsified != 0U)
+    {
+        return falsified;
+    }
+
+    // Cardinality constraints are numbered after the clauses:
+    for (size_t card_i = 0U; card_i < FORMULA_num_cardinalities(formula); ++card_i)
+    {
+        const CARDINALITY* card = FORMULA_get_cardinality(formula, card_i);
+
+        size_t num_true = 0U;
+        for (size_t lit_i = 0U; lit_i < CARDINALITY_size(card); ++lit_i)
+        {
+            literal_t lit = CARDINALITY_get(card, lit_i);
+
+            if (LITERAL_VALUE_Get(lit) > model->num_variables)
+            {
+                num_true += (lit & LITERAL_CONTRARY_BIT) != 0U;
+            }
+            else
+            {
+                num_true += MODEL_literal_is_true(model, lit);
+            }
+        }
+
+        if (num_true > card->bound)
+        {
+            return FORMULA_size(formula) + card_i + 1U;
+        }
+    }
+
+    return 0U;
+}
+
+#endif // DPLL_MODEL_H
@@ -0,0 +1,499 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_OPTIONS_H
+#define DPLL_OPTIONS_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "generator.h"
+#include "reorder.h"
+
+//======================//
+// Command line options //
+//======================//
+
+typedef struct
+{
+    // Input formula:
+    const char* filename;
+
+    // Number of search threads (zero if not specified):
+    size_t num_jobs;
+
+    // Batch mode:
+    bool batch_mode;
+    const char** inputs;
+    size_t num_inputs;
+
+    // Solve variable-disjoint components independently:
+    bool components;
+
+    // Cube-and-conquer mode:
+    bool cube_mode;
+    unsigned cube_depth;
+    const char* cubes_in;
+    const char* cubes_out;
+    size_t cube_first;
+    size_t cube_last;
+
+    // Stochastic local search (instead of or before the systematic search):
+    bool local_search;
+    bool local_search_first;
+    size_t flips;
+
+    // Decision polarity from local search bursts (zero interval for a single burst):
+    bool phase_search;
+    size_t phase_conflicts;
+
+    // Renumbering of the variables for memory locality:
+    reorder_t reorder;
+
+    // Replace the pairwise at-most-one encodings with cardinality constraints:
+    bool detect_amo;
+
+    // Count the models instead of finding one:
+    bool count;
+
+    // Memory budget of the component cache in megabytes (zero disables the cache):
+    size_t count_cache;
+
+    // Print search statistics:
+    bool stats;
+
+    // Print the satisfying assignment:
+    bool model;
+
+    // Check the satisfying assignment against the input formula:
+    bool verify;
+
+    // DRAT proof of unsatisfiability (NULL if not logged):
+    const char* proof;
+    bool binary_proof;
+
+    // Progress report intervals (zero if disabled):
+    size_t progress_conflicts;
+    size_t progress_seconds;
+
+    // Memory limit in megabytes (zero if unlimited):
+    size_t mem_limit;
+
+    // Search budgets (zero if unlimited):
+    size_t time_limit;
+    size_t conflict_limit;
+    size_t decision_limit;
+    size_t propagation_limit;
+
+    // Generated instance instead of the input formula:
+    const char*    generate;
+    GENERATOR_SPEC generator;
+    uint64_t       seed;
+    const char*    generate_out;
+} OPTIONS;
+
+// Default depth of the cube split (up to 4096 cubes, the lookahead refutes part of them):
+#define OPTIONS_CUBE_DEPTH 12U
+
+// Default flip budget of the local search preceding the systematic search:
+#define OPTIONS_LOCAL_SEARCH_FLIPS 100000U
+
+// Default number of conflicts between the local search bursts guiding the decisions:
+#define OPTIONS_PHASE_CONFLICTS 10000U
+
+// Default memory budget of the model counter cache (measured in megabytes):
+#define OPTIONS_COUNT_CACHE 256U
+
+void OPTIONS_usage(const char* program)
+{
+    printf("Usage: %s [options] ./path/to/file.cnf\n", program);
+    printf("       %s --batch [options] (file.cnf | directory)...\n", program);
+    printf("       %s --generate SPEC [--seed N] [--generate-out FILE] [options]\n", program);
+    printf("Options:\n");
+    printf("  -j, --jobs N            solve with N threads\n");
+    printf("  --batch                 solve many formulas on a pool of threads\n");
+    printf("  --components            solve variable-disjoint components independently\n");
+    printf("  --cube                  cube-and-conquer mode\n");
+    printf("  --cube-depth N          split the search tree into cubes up to depth N (default: %u)\n",
+        OPTIONS_CUBE_DEPTH);
+    printf("  --cubes-out FILE        write the cubes to FILE and stop\n");
+    printf("  --cubes-in FILE         conquer the cubes read from FILE\n");
+    printf("  --cube-range FIRST:LAST conquer only cubes [FIRST, LAST)\n");
+    printf("  --local-search          solve with probSAT local search (finds SAT only)\n");
+    printf("  --local-search-first    try local search before the systematic search\n");
+    printf("  --flips N               local search flip budget (default: %u before the search)\n",
+        OPTIONS_LOCAL_SEARCH_FLIPS);
+    printf("  --phase-search          take decision polarity from local search bursts\n");
+    printf("  --phase-conflicts N     run a burst every N conflicts (default: %u, 0 for one burst)\n",
+        OPTIONS_PHASE_CONFLICTS);
+    printf("  --reorder ORDER         renumber the variables by ORDER before the search, one of:\n");
+    printf("                            cm (Cuthill-McKee), first (first occurrence)\n");
+    printf("  --detect-amo            replace pairwise at-most-one encodings with cardinality constraints\n");
+    printf("  --count                 count the models over the declared variables\n");
+    printf("  --count-cache MB        memory budget of the component cache (default: %u, 0 to disable)\n",
+        OPTIONS_COUNT_CACHE);
+    printf("  --stats                 print statistics of the sequential search\n");
+    printf("  --model                 print the satisfying assignment as v-lines\n");
+    printf("  --verify                check the satisfying assignment against the input formula\n");
+    printf("  --proof FILE            write the DRAT proof of unsatisfiability to FILE\n");
+    printf("  --binary-proof          write the proof in the binary DRAT format\n");
+    printf("  --progress-conflicts N  report the search progress every N conflicts\n");
+    printf("  --progress-seconds S    report the search progress every S seconds\n");
+    printf("  --mem-limit MB          stop with UNKNOWN before exceeding MB of resident memory\n");
+    printf("  --time-limit S          stop with UNKNOWN after S seconds\n");
+    printf("  --conflict-limit N      stop with UNKNOWN after N conflicts\n");
+    printf("  --decision-limit N      stop with UNKNOWN after N decisions\n");
+    printf("  --propagation-limit N   stop with UNKNOWN after N propagations\n");
+    printf("  --generate SPEC         solve a generated instance, SPEC is one of:\n");
+    printf("                            ksat:K:VARS:RATIO, php:HOLES,\n");
+    printf("                            parity:LENGTH[:unsat], coloring:VERTICES:EDGES:COLORS\n");
+    printf("  --seed N                seed of the generated instance (default: 1)\n");
+    printf("  --generate-out FILE     write the generated instance to FILE and stop\n");
+
+    exit(EXIT_FAILURE);
+}
+
+// Read an unsigned numeric option argument.
+size_t OPTIONS_read_number(int argc, char* argv[], int* arg_i)
+{
+    if (*arg_i + 1 >= argc)
+    {
+        OPTIONS_usage(argv[0]);
+    }
+
+    *arg_i += 1;
+
+    char* endptr = NULL;
+    unsigned long long value = strtoull(argv[*arg_i], &endptr, 10);
+    if (endptr == argv[*arg_i] || *endptr != '\0')
+    {
+        printf("Invalid numeric argument \"%s\"\n", argv[*arg_i]);
+        OPTIONS_usage(argv[0]);
+    }
+
+    return value;
+}
+
+// Read a string option argument.
+const char* OPTIONS_read_string(int argc, char* argv[], int* arg_i)
+{
+    if (*arg_i + 1 >= argc)
+    {
+        OPTIONS_usage(argv[0]);
+    }
+
+    *arg_i += 1;
+
+    return argv[*arg_i];
+}
+
+void OPTIONS_parse(OPTIONS* options, int argc, char* argv[])
+{
+    options->filename = NULL;
+    options->num_jobs = 0U;
+
+    options->batch_mode = false;
+    options->num_inputs = 0U;
+    options->inputs     = calloc(argc, sizeof(const char*));
+    VERIFY_CONTRACT(options->inputs != NULL,
+        "[%s] Unable to allocate input list\n", "OPTIONS_parse");
+
+    options->components = false;
+
+    options->cube_mode  = false;
+    options->cube_depth = OPTIONS_CUBE_DEPTH;
+    options->cubes_in   = NULL;
+    options->cubes_out  = NULL;
+    options->cube_first = 0U;
+    options->cube_last  = SIZE_MAX;
+
+    options->local_search       = false;
+    options->local_search_first = false;
+    options->flips              = SIZE_MAX;
+
+    options->phase_search    = false;
+    options->phase_conflicts = OPTIONS_PHASE_CONFLICTS;
+
+    options->reorder = REORDER_NONE;
+
+    options->detect_amo = false;
+
+    options->count       = false;
+    options->count_cache = OPTIONS_COUNT_CACHE;
+
+    options->stats  = false;
+    options->model  = false;
+    options->verify = false;
+
+    options->proof        = NULL;
+    options->binary_proof = false;
+
+    options->progress_conflicts = 0U;
+    options->progress_seconds   = 0U;
+
+    options->mem_limit = 0U;
+
+    options->time_limit        = 0U;
+    options->conflict_limit    = 0U;
+    options->decision_limit    = 0U;
+    options->propagation_limit = 0U;
+
+    options->generate     = NULL;
+    options->seed         = 1U;
+    options->generate_out = NULL;
+
+    for (int arg_i = 1; arg_i < argc; ++arg_i)
+    {
+        const char* arg = argv[arg_i];
+
+        if (strcmp(arg, "-j") == 0 || strcmp(arg, "--jobs") == 0)
+        {
+            options->num_jobs = OPTIONS_read_number(argc, argv, &arg_i);
+            if (options->num_jobs == 0U)
+            {
+                OPTIONS_usage(argv[0]);
+            }
+        }
+        else if (strcmp(arg, "--batch") == 0)
+        {
+            options->batch_mode = true;
+        }
+        else if (strcmp(arg, "--components") == 0)
+        {
+            options->components = true;
+        }
+        else if (strcmp(arg, "--cube") == 0)
+        {
+            options->cube_mode = true;
+        }
+        else if (strcmp(arg, "--cube-depth") == 0)
+        {
+            options->cube_mode  = true;
+            options->cube_depth = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--cubes-out") == 0)
+        {
+            options->cube_mode = true;
+            options->cubes_out = OPTIONS_read_string(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--cubes-in") == 0)
+        {
+            options->cube_mode = true;
+            options->cubes_in  = OPTIONS_read_string(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--cube-range") == 0)
+        {
+            const char* range = OPTIONS_read_string(argc, argv, &arg_i);
+            if (sscanf(range, "%zu:%zu", &options->cube_first, &options->cube_last) != 2 ||
+                options->cube_first >= options->cube_last)
+            {
+                printf("Invalid cube range \"%s\"\n", range);
+                OPTIONS_usage(argv[0]);
+            }
+
+            options->cube_mode = true;
+        }
+        else if (strcmp(arg, "--local-search") == 0)
+        {
+            options->local_search = true;
+        }
+        else if (strcmp(arg, "--local-search-first") == 0)
+        {
+            options->local_search_first = true;
+        }
+        else if (strcmp(arg, "--flips") == 0)
+        {
+            options->flips = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--phase-search") == 0)
+        {
+            options->phase_search = true;
+        }
+        else if (strcmp(arg, "--phase-conflicts") == 0)
+        {
+            options->phase_search    = true;
+            options->phase_conflicts = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--reorder") == 0)
+        {
+            const char* order = OPTIONS_read_string(argc, argv, &arg_i);
+            if (!REORDER_parse(&options->reorder, order))
+            {
+                printf("Invalid variable order \"%s\"\n", order);
+                OPTIONS_usage(argv[0]);
+            }
+        }
+        else if (strcmp(arg, "--detect-amo") == 0)
+        {
+            options->detect_amo = true;
+        }
+        else if (strcmp(arg, "--count") == 0)
+        {
+            options->count = true;
+        }
+        else if (strcmp(arg, "--count-cache") == 0)
+        {
+            options->count_cache = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--stats") == 0)
+        {
+            options->stats = true;
+        }
+        else if (strcmp(arg, "--model") == 0)
+        {
+            options->model = true;
+        }
+        else if (strcmp(arg, "--verify") == 0)
+        {
+            options->verify = true;
+        }
+        else if (strcmp(arg, "--proof") == 0)
+        {
+            options->proof = OPTIONS_read_string(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--binary-proof") == 0)
+        {
+            options->binary_proof = true;
+        }
+        else if (strcmp(arg, "--progress-conflicts") == 0)
+        {
+            options->progress_conflicts = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--progress-seconds") == 0)
+        {
+            options->progress_seconds = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--mem-limit") == 0)
+        {
+            options->mem_limit = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--time-limit") == 0)
+        {
+            options->time_limit = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--conflict-limit") == 0)
+        {
+            options->conflict_limit = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--decision-limit") == 0)
+        {
+            options->decision_limit = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--propagation-limit") == 0)
+        {
+            options->propagation_limit = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--generate") == 0)
+        {
+            options->generate = OPTIONS_read_string(argc, argv, &arg_i);
+            if (!GENERATOR_SPEC_parse(&options->generator, options->generate))
+            {
+                printf("Invalid instance description \"%s\"\n", options->generate);
+                OPTIONS_usage(argv[0]);
+            }
+        }
+        else if (strcmp(arg, "--seed") == 0)
+        {
+            options->seed = OPTIONS_read_number(argc, argv, &arg_i);
+        }
+        else if (strcmp(arg, "--generate-out") == 0)
+        {
+            options->generate_out = OPTIONS_read_string(argc, argv, &arg_i);
+        }
+        else if (arg[0] == '-')
+        {
+            OPTIONS_usage(argv[0]);
+        }
+        else
+        {
+            options->inputs[options->num_inputs++] = arg;
+        }
+    }
+
+    // Local search replaces every other search mode:
+    if (options->local_search &&
+        (options->local_search_first || options->proof != NULL || options->phase_search ||
+         options->cube_mode || options->components || options->num_jobs > 1U))
+    {
+        OPTIONS_usage(argv[0]);
+    }
+
+    if ((options->local_search || options->local_search_first) && options->batch_mode)
+    {
+        OPTIONS_usage(argv[0]);
+    }
+
+    // The engine runs until a limit is hit unless given a flip budget:
+    if (options->flips == SIZE_MAX)
+    {
+        options->flips = options->local_search? 0U : OPTIONS_LOCAL_SEARCH_FLIPS;
+    }
+
+    // Proofs and phases are supported by the sequential search only:
+    if ((options->proof != NULL || options->phase_search) &&
+        (options->batch_mode || options->cube_mode || options->components || options->num_jobs > 1U))
+    {
+        OPTIONS_usage(argv[0]);
+    }
+
+    // Budgets stop the sequential search only (other modes derive UNSAT from completed searches):
+    bool budgets = options->mem_limit != 0U || options->time_limit != 0U || options->conflict_limit != 0U ||
+                   options->decision_limit != 0U || options->propagation_limit != 0U;
+    if (budgets &&
+        (options->batch_mode || options->cube_mode || options->components || options->num_jobs > 1U))
+    {
+        OPTIONS_usage(argv[0]);
+    }
+
+    // Cardinality constraints are propagated by the sequential search only:
+    if (options->detect_amo &&
+        (options->local_search || options->local_search_first || options->batch_mode ||
+         options->cube_mode || options->components || options->num_jobs > 1U))
+    {
+        OPTIONS_usage(argv[0]);
+    }
+
+    // Model counter finds no single model and counts over the input numbering:
+    if (options->count &&
+        (options->local_search || options->local_search_first || options->batch_mode ||
+         options->cube_mode || options->components || options->num_jobs > 1U ||
+         options->proof != NULL || options->phase_search || options->reorder != REORDER_NONE ||
+         options->detect_amo || options->model || options->verify))
+    {
+        OPTIONS_usage(argv[0]);
+    }
+
+    // Cube files and batch inputs are in the input numbering:
+    if (options->reorder != REORDER_NONE &&
+        (options->batch_mode || options->cubes_in != NULL || options->cubes_out != NULL))
+    {
+        OPTIONS_usage(argv[0]);
+    }
+
+    if (options->generate != NULL)
+    {
+        // Generated instance replaces the input:
+        if (options->batch_mode || options->num_inputs != 0U)
+        {
+            OPTIONS_usage(argv[0]);
+        }
+
+        return;
+    }
+
+    if (options->generate_out != NULL ||
+        options->num_inputs == 0U || (!options->batch_mode && options->num_inputs != 1U))
+    {
+        OPTIONS_usage(argv[0]);
+    }
+
+    options->filename = options->inputs[0U];
+}
+
+void OPTIONS_free(OPTIONS* options)
+{
+    free(options->inputs);
+}
+
+#endif // DPLL_OPTIONS_H
@@ -0,0 +1,402 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_PARALLEL_H
+#define DPLL_PARALLEL_H
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <threads.h>
+
+#include "solver.h"
+
+//========================//
+// Guiding path data type //
+//========================//
+
+// Guiding path is a set of literals fixing a subtree of the search tree.
+// The literals are asserted before the formula is preprocessed.
+typedef struct
+{
+    literal_t* literals;
+    size_t size;
+} JOB;
+
+bool JOB_eq(const JOB* el1, const JOB* el2)
+{
+    return el1->literals == el2->literals;
+}
+
+bool JOB_lt(const JOB* el1, const JOB* el2)
+{
+    return el1->size < el2->size;
+}
+
+// Parametrize stack with job data type:
+#define DATA_T         JOB
+#define DATA_STRUCTURE JOB_STORAGE
+#include "template_stack.h"
+
+// Split the search tree of the trial by the shallowest open decision.
+// The trial keeps the decision branch, the job gets the untried one.
+//
+// Return false if there are no open decisions in the trial.
+bool JOB_split_trial(TRIAL* trial, JOB* job)
+{
+    // Find the shallowest open decision:
+    size_t decision_i = 0U;
+    while (decision_i < trial->literals.size &&
+           !(LIT_STORAGE_get(&trial->literals, decision_i) & LITERAL_DECISION_BIT))
+    {
+        decision_i += 1U;
+    }
+
+    if (decision_i == trial->literals.size)
+    {
+        return false;
+    }
+
+    // Job consists of the level-zero literals and the flipped decision:
+    job->size     = decision_i + 1U;
+    job->literals = calloc(job->size, sizeof(literal_t));
+    VERIFY_CONTRACT(job->literals != NULL,
+        "[%s] Unable to allocate guiding path of size %zu\n",
+        "JOB_split_trial", job->size);
+
+    memcpy(job->literals, trial->literals.array, decision_i * sizeof(literal_t));
+
+    literal_t decision = LIT_STORAGE_get(&trial->literals, decision_i);
+    job->literals[decision_i] = (decision & ~LITERAL_DECISION_BIT) ^ LITERAL_CONTRARY_BIT;
+
+    // The decision is never flipped by the trial from now on:
+    trial->literals.array[decision_i] &= ~LITERAL_DECISION_BIT;
+    trial->level -= 1U;
+
+    return true;
+}
+
+void JOB_free(JOB* job)
+{
+    free(job->literals);
+}
+
+//=================================//
+// Work-stealing solver structures //
+//=================================//
+
+typedef struct PARALLEL_SOLVER PARALLEL_SOLVER;
+
+typedef struct
+{
+    // Job deque: the owner works at the top, thieves steal from the bottom:
+    JOB_STORAGE deque;
+    mtx_t       deque_lock;
+
+    // Owner solver:
+    PARALLEL_SOLVER* solver;
+
+    thrd_t thread;
+} WORKER;
+
+struct PARALLEL_SOLVER
+{
+    const FORMULA* formula;
+
+    WORKER* workers;
+    size_t  num_workers;
+
+    // Number of jobs that are not refuted yet:
+    atomic_size_t outstanding;
+
+    // Number of workers waiting for a job:
+    atomic_uint hungry;
+
+    // Termination flag and the result:
+    atomic_bool done;
+    atomic_int  result;
+
+    // Satisfying assignment (if not NULL):
+    VARIABLES* model;
+
+    // Sleeping place for the hungry workers:
+    mtx_t idle_lock;
+    cnd_t idle_cond;
+};
+
+void WORKER_push_job(WORKER* worker, JOB job)
+{
+    mtx_lock(&worker->deque_lock);
+    JOB_STORAGE_push(&worker->deque, job);
+    mtx_unlock(&worker->deque_lock);
+}
+
+bool WORKER_pop_job(WORKER* worker, JOB* job)
+{
+    mtx_lock(&worker->deque_lock);
+    bool ret = JOB_STORAGE_pop(&worker->deque, job);
+    mtx_unlock(&worker->deque_lock);
+
+    return ret;
+}
+
+bool WORKER_steal_job(WORKER* victim, JOB* job)
+{
+    bool ret = false;
+
+    mtx_lock(&victim->deque_lock);
+    if (victim->deque.size != 0U)
+    {
+        // Oldest job corresponds to the shallowest decision:
+        JOB_STORAGE_remove(&victim->deque, job, 0U);
+        ret = true;
+    }
+    mtx_unlock(&victim->deque_lock);
+
+    return ret;
+}
+
+bool WORKER_has_jobs(WORKER* worker)
+{
+    mtx_lock(&worker->deque_lock);
+    bool ret = worker->deque.size != 0U;
+    mtx_unlock(&worker->deque_lock);
+
+    return ret;
+}
+
+//================================//
+// Work-stealing search algorithm //
+//================================//
+
+void parallel_finish(PARALLEL_SOLVER* solver, sat_t result, const VARIABLES* model)
+{
+    mtx_lock(&solver->idle_lock);
+
+    if (!atomic_load(&solver->done))
+    {
+        if (result == SAT && solver->model != NULL)
+        {
+            *solver->model = *model;
+        }
+
+        atomic_store(&solver->result, result);
+        atomic_store(&solver->done, true);
+    }
+
+    cnd_broadcast(&solver->idle_cond);
+    mtx_unlock(&solver->idle_lock);
+}
+
+bool parallel_acquire_job(WORKER* worker, JOB* job)
+{
+    PARALLEL_SOLVER* solver = worker->solver;
+
+    if (WORKER_pop_job(worker, job))
+    {
+        return true;
+    }
+
+    size_t self = worker - solver->workers;
+    for (size_t i = 1U; i < solver->num_workers; ++i)
+    {
+        WORKER* victim = &solver->workers[(self + i) % solver->num_workers];
+        if (WORKER_steal_job(victim, job))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool parallel_has_jobs(PARALLEL_SOLVER* solver)
+{
+    for (size_t i = 0U; i < solver->num_workers; ++i)
+    {
+        if (WORKER_has_jobs(&solver->workers[i]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Give away the untried branch of the shallowest open decision.
+void parallel_split_work(WORKER* worker, TRIAL* trial)
+{
+    PARALLEL_SOLVER* solver = worker->solver;
+
+    JOB job;
+    if (!JOB_split_trial(trial, &job))
+    {
+        return;
+    }
+
+    atomic_fetch_add(&solver->outstanding, 1U);
+    WORKER_push_job(worker, job);
+
+    mtx_lock(&solver->idle_lock);
+    cnd_signal(&solver->idle_cond);
+    mtx_unlock(&solver->idle_lock);
+}
+
+// Solve the subtree fixed by the guiding path.
+// The satisfying assignment is stored into model.
+//
+// Return UNDEF if the search is interrupted.
+sat_t parallel_solve_job(WORKER* worker, const JOB* job, VARIABLES* model)
+{
+    PARALLEL_SOLVER* solver = worker->solver;
+
+    TRIAL trial;
+    FORMULA formula;
+
+    sat_t sat_flag = dpll_init_search(solver->formula, &formula, &trial, NULL,
+                                      job->literals, job->size);
+
+    while (sat_flag == UNDEF)
+    {
+        if (atomic_load_explicit(&solver->done, memory_order_relaxed))
+        {
+            break;
+        }
+
+        // Feed the hungry workers:
+        if (atomic_load_explicit(&solver->hungry, memory_order_relaxed) != 0U &&
+            !WORKER_has_jobs(worker))
+        {
+            parallel_split_work(worker, &trial);
+        }
+
+        sat_flag = dpll_step(&trial, &formula);
+    }
+
+    if (sat_flag == SAT)
+    {
+        *model = trial.variables;
+    }
+
+    FORMULA_free(&formula);
+    TRIAL_free(&trial);
+
+    return sat_flag;
+}
+
+int parallel_worker_main(void* arg)
+{
+    WORKER* worker = arg;
+    PARALLEL_SOLVER* solver = worker->solver;
+
+    while (!atomic_load(&solver->done))
+    {
+        JOB job;
+        if (!parallel_acquire_job(worker, &job))
+        {
+            // Wait for busy workers to split their search trees:
+            mtx_lock(&solver->idle_lock);
+            atomic_fetch_add(&solver->hungry, 1U);
+
+            if (!atomic_load(&solver->done) && !parallel_has_jobs(solver))
+            {
+                cnd_wait(&solver->idle_cond, &solver->idle_lock);
+            }
+
+            atomic_fetch_sub(&solver->hungry, 1U);
+            mtx_unlock(&solver->idle_lock);
+
+            continue;
+        }
+
+        VARIABLES model;
+        sat_t sat_flag = parallel_solve_job(worker, &job, &model);
+        JOB_free(&job);
+
+        if (sat_flag == SAT)
+        {
+            parallel_finish(solver, SAT, &model);
+        }
+        else if (sat_flag == UNSAT)
+        {
+            // Formula is UNSAT only if every subtree is refuted:
+            if (atomic_fetch_sub(&solver->outstanding, 1U) == 1U)
+            {
+                parallel_finish(solver, UNSAT, NULL);
+            }
+        }
+    }
+
+    return 0;
+}
+
+//
+// General parallel solver algorithm
+//
+
+// The satisfying assignment is stored into model (if not NULL).
+sat_t dpll_solve_parallel(const FORMULA* initial_formula, VARIABLES* model, size_t num_workers)
+{
+    PARALLEL_SOLVER solver;
+    solver.formula     = initial_formula;
+    solver.model       = model;
+    solver.num_workers = num_workers;
+
+    atomic_init(&solver.outstanding, 1U);
+    atomic_init(&solver.hungry, 0U);
+    atomic_init(&solver.done, false);
+    atomic_init(&solver.result, UNDEF);
+
+    mtx_init(&solver.idle_lock, mtx_plain);
+    cnd_init(&solver.idle_cond);
+
+    solver.workers = calloc(num_workers, sizeof(WORKER));
+    VERIFY_CONTRACT(solver.workers != NULL,
+        "[%s] Unable to allocate %zu workers\n", "dpll_solve_parallel", num_workers);
+
+    for (size_t i = 0U; i < num_workers; ++i)
+    {
+        WORKER* worker = &solver.workers[i];
+
+        JOB_STORAGE_init(&worker->deque, JOB_eq, JOB_lt, false /*sorted*/);
+        mtx_init(&worker->deque_lock, mtx_plain);
+
+        worker->solver = &solver;
+    }
+
+    // The whole search tree is the initial job:
+    JOB root = {.literals = NULL, .size = 0U};
+    WORKER_push_job(&solver.workers[0U], root);
+
+    for (size_t i = 0U; i < num_workers; ++i)
+    {
+        int ret = thrd_create(&solver.workers[i].thread, parallel_worker_main, &solver.workers[i]);
+        VERIFY_CONTRACT(ret == thrd_success,
+            "[%s] Unable to start worker #%zu\n", "dpll_solve_parallel", i);
+    }
+
+    for (size_t i = 0U; i < num_workers; ++i)
+    {
+        thrd_join(solver.workers[i].thread, NULL);
+    }
+
+    for (size_t i = 0U; i < num_workers; ++i)
+    {
+        WORKER* worker = &solver.workers[i];
+
+        JOB job;
+        while (JOB_STORAGE_pop(&worker->deque, &job))
+        {
+            JOB_free(&job);
+        }
+
+        JOB_STORAGE_free(&worker->deque);
+        mtx_destroy(&worker->deque_lock);
+    }
+
+    free(solver.workers);
+
+    cnd_destroy(&solver.idle_cond);
+    mtx_destroy(&solver.idle_lock);
+
+    return atomic_load(&solver.result);
+}
+
+#endif // DPLL_PARALLEL_H
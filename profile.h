@@ -0,0 +1,221 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_PROFILE_H
+#define DPLL_PROFILE_H
+
+// Instrumentation layer selected at compile time:
+// - DPLL_PROFILE enables scoped timers for the solver phases;
+// - DPLL_PROFILE_CYCLES also enables cycle counters on the hot paths.
+// Without these macros every probe expands to nothing.
+
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "utils.h"
+
+typedef enum
+{
+    // Phases measured in nanoseconds:
+    PROFILE_LOAD_FORMULA,
+    PROFILE_PREPROCESS,
+    PROFILE_LINK_WATCHES,
+    PROFILE_PROPAGATE,
+    PROFILE_DECIDE,
+    PROFILE_BACKTRACK,
+
+    // Hot paths measured in cycles:
+    PROFILE_NOTIFY_WATCHES,
+    PROFILE_SELECT_LITERAL,
+    PROFILE_POP_TO_DECISION,
+
+    PROFILE_NUM_PROBES
+} profile_probe_t;
+
+#define PROFILE_FIRST_CYCLES_PROBE PROFILE_NOTIFY_WATCHES
+
+#ifdef DPLL_PROFILE
+
+#include <stdio.h>
+#include <time.h>
+#include <threads.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+//===================//
+// Measurement table //
+//===================//
+
+typedef struct
+{
+    uint64_t calls[PROFILE_NUM_PROBES];
+    uint64_t total[PROFILE_NUM_PROBES];
+} PROFILE_TABLE;
+
+const char* PROFILE_NAMES[PROFILE_NUM_PROBES] =
+{
+    [PROFILE_LOAD_FORMULA]    = "DIMACS_load_formula",
+    [PROFILE_PREPROCESS]      = "dpll_preprocess_formula",
+    [PROFILE_LINK_WATCHES]    = "WATCH_LIST_link_initial",
+    [PROFILE_PROPAGATE]       = "propagation",
+    [PROFILE_DECIDE]          = "decision",
+    [PROFILE_BACKTRACK]       = "backtracking",
+    [PROFILE_NOTIFY_WATCHES]  = "dpll_notify_watches",
+    [PROFILE_SELECT_LITERAL]  = "dpll_select_literal",
+    [PROFILE_POP_TO_DECISION] = "TRIAL_pop_to_last_decision"
+};
+
+// Every thread accumulates into its own table,
+// the tables are merged on thread exit:
+_Thread_local PROFILE_TABLE* profile_local = NULL;
+
+PROFILE_TABLE profile_merged;
+mtx_t         profile_lock;
+tss_t         profile_key;
+once_flag     profile_once = ONCE_FLAG_INIT;
+
+void PROFILE_merge(PROFILE_TABLE* table)
+{
+    mtx_lock(&profile_lock);
+
+    for (unsigned probe = 0U; probe < PROFILE_NUM_PROBES; ++probe)
+    {
+        profile_merged.calls[probe] += table->calls[probe];
+        profile_merged.total[probe] += table->total[probe];
+    }
+
+    mtx_unlock(&profile_lock);
+}
+
+void PROFILE_thread_exit(void* table)
+{
+    PROFILE_merge(table);
+    free(table);
+}
+
+// Print the breakdown of the measurements.
+// NOTE: phases are inclusive, e.g. propagation contains the watch notifications.
+void PROFILE_report(void)
+{
+    // The main thread never runs the thread-exit destructor:
+    if (profile_local != NULL)
+    {
+        PROFILE_merge(profile_local);
+        free(profile_local);
+
+        profile_local = NULL;
+    }
+
+    fprintf(stderr, "c %-28s %12s %14s %14s\n", "probe", "calls", "total", "average");
+
+    for (unsigned probe = 0U; probe < PROFILE_NUM_PROBES; ++probe)
+    {
+        uint64_t calls = profile_merged.calls[probe];
+        uint64_t total = profile_merged.total[probe];
+
+        if (calls == 0U)
+        {
+            continue;
+        }
+
+        if (probe < PROFILE_FIRST_CYCLES_PROBE)
+        {
+            fprintf(stderr, "c %-28s %12"PRIu64" %11.3f ms %11.3f us\n",
+                PROFILE_NAMES[probe], calls, 1e-6 * total, 1e-3 * total / calls);
+        }
+        else
+        {
+            fprintf(stderr, "c %-28s %12"PRIu64" %9.3f Mcyc %8.1f cyc\n",
+                PROFILE_NAMES[probe], calls, 1e-6 * total, (double) total / calls);
+        }
+    }
+}
+
+void PROFILE_setup(void)
+{
+    mtx_init(&profile_lock, mtx_plain);
+    tss_create(&profile_key, PROFILE_thread_exit);
+
+    atexit(PROFILE_report);
+}
+
+PROFILE_TABLE* PROFILE_thread_table(void)
+{
+    call_once(&profile_once, PROFILE_setup);
+
+    PROFILE_TABLE* table = calloc(1U, sizeof(PROFILE_TABLE));
+    VERIFY_CONTRACT(table != NULL,
+        "[%s] Unable to allocate profile table\n", "PROFILE_thread_table");
+
+    // Register the table for the merge on thread exit:
+    tss_set(profile_key, table);
+
+    return table;
+}
+
+void PROFILE_add(profile_probe_t probe, uint64_t elapsed)
+{
+    if (profile_local == NULL)
+    {
+        profile_local = PROFILE_thread_table();
+    }
+
+    profile_local->calls[probe] += 1U;
+    profile_local->total[probe] += elapsed;
+}
+
+//========//
+// Clocks //
+//========//
+
+uint64_t PROFILE_nanoseconds(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return 1000000000U * (uint64_t) time.tv_sec + time.tv_nsec;
+}
+
+uint64_t PROFILE_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    // No portable cycle counter, fall back to nanoseconds:
+    return PROFILE_nanoseconds();
+#endif
+}
+
+//========//
+// Probes //
+//========//
+
+#define PROFILE_BEGIN(probe) \
+    uint64_t profile_start_##probe = PROFILE_nanoseconds()
+
+#define PROFILE_END(probe) \
+    PROFILE_add(probe, PROFILE_nanoseconds() - profile_start_##probe)
+
+#ifdef DPLL_PROFILE_CYCLES
+
+#define PROFILE_CYCLES_BEGIN(probe) \
+    uint64_t profile_start_##probe = PROFILE_cycles()
+
+#define PROFILE_CYCLES_END(probe) \
+    PROFILE_add(probe, PROFILE_cycles() - profile_start_##probe)
+
+#endif // DPLL_PROFILE_CYCLES
+
+#else
+
+#define PROFILE_BEGIN(probe) do {} while (0)
+#define PROFILE_END(probe)   do {} while (0)
+
+#endif // DPLL_PROFILE
+
+#ifndef PROFILE_CYCLES_BEGIN
+#define PROFILE_CYCLES_BEGIN(probe) do {} while (0)
+#define PROFILE_CYCLES_END(probe)   do {} while (0)
+#endif
+
+#endif // DPLL_PROFILE_H
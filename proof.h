@@ -0,0 +1,262 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_PROOF_H
+#define DPLL_PROOF_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <threads.h>
+
+#include "formula.h"
+
+//=====================//
+// DRAT proof emission //
+//=====================//
+
+// Proof lines are accumulated in a buffer on the solver thread,
+// full buffers are written to the file by a dedicated writer thread.
+#define PROOF_BUFFER_SIZE (4U * 1024U * 1024U)
+
+// Upper bound on the bytes of a literal in either format:
+#define PROOF_LITERAL_SIZE 8U
+
+typedef struct
+{
+    FILE* file;
+    bool  binary;
+
+    // Buffer being filled by the solver:
+    char*  buffer;
+    size_t size;
+
+    // Buffer being written by the writer thread:
+    char*  flushing;
+    size_t flushing_size;
+
+    thrd_t writer;
+    mtx_t  lock;
+    cnd_t  cond;
+    bool   closing;
+
+    // Derived clauses that are not yet subsumed (see dpll_proof_conflict):
+    LIT_STORAGE pending;
+
+    // Input number of every variable of the solved formula (NULL if the variables are not renamed):
+    const uint16_t* names;
+} PROOF;
+
+int PROOF_writer_main(void* arg)
+{
+    PROOF* proof = arg;
+
+    mtx_lock(&proof->lock);
+
+    while (true)
+    {
+        while (proof->flushing_size == 0U && !proof->closing)
+        {
+            cnd_wait(&proof->cond, &proof->lock);
+        }
+
+        if (proof->flushing_size == 0U)
+        {
+            break;
+        }
+
+        // Write without holding the lock:
+        mtx_unlock(&proof->lock);
+        fwrite(proof->flushing, 1U, proof->flushing_size, proof->file);
+        mtx_lock(&proof->lock);
+
+        proof->flushing_size = 0U;
+        cnd_broadcast(&proof->cond);
+    }
+
+    mtx_unlock(&proof->lock);
+
+    return 0;
+}
+
+// Open the proof file.
+//
+// Return false if the file can not be opened.
+bool PROOF_open(PROOF* proof, const char* filename, bool binary)
+{
+    proof->file = fopen(filename, binary? "wb" : "w");
+    if (proof->file == NULL)
+    {
+        return false;
+    }
+
+    proof->binary = binary;
+
+    proof->buffer   = malloc(PROOF_BUFFER_SIZE);
+    proof->flushing = malloc(PROOF_BUFFER_SIZE);
+    VERIFY_CONTRACT(proof->buffer != NULL && proof->flushing != NULL,
+        "[%s] Unable to allocate proof buffers\n", "PROOF_open");
+
+    proof->size          = 0U;
+    proof->flushing_size = 0U;
+    proof->closing       = false;
+
+    proof->names = NULL;
+
+    LIT_STORAGE_init(&proof->pending, LITERAL_eq_contrarity, LITERAL_lt, false /*sorted*/);
+
+    mtx_init(&proof->lock, mtx_plain);
+    cnd_init(&proof->cond);
+
+    int ret = thrd_create(&proof->writer, PROOF_writer_main, proof);
+    VERIFY_CONTRACT(ret == thrd_success,
+        "[%s] Unable to start proof writer\n", "PROOF_open");
+
+    return true;
+}
+
+// Hand the filled buffer over to the writer thread.
+void PROOF_flush(PROOF* proof)
+{
+    mtx_lock(&proof->lock);
+
+    // Wait for the previous buffer to be written:
+    while (proof->flushing_size != 0U)
+    {
+        cnd_wait(&proof->cond, &proof->lock);
+    }
+
+    char* filled = proof->buffer;
+    proof->buffer   = proof->flushing;
+    proof->flushing = filled;
+
+    proof->flushing_size = proof->size;
+    proof->size          = 0U;
+
+    cnd_broadcast(&proof->cond);
+    mtx_unlock(&proof->lock);
+}
+
+void PROOF_close(PROOF* proof)
+{
+    if (proof->size != 0U)
+    {
+        PROOF_flush(proof);
+    }
+
+    mtx_lock(&proof->lock);
+    proof->closing = true;
+    cnd_broadcast(&proof->cond);
+    mtx_unlock(&proof->lock);
+
+    thrd_join(proof->writer, NULL);
+
+    fclose(proof->file);
+
+    free(proof->buffer);
+    free(proof->flushing);
+
+    LIT_STORAGE_free(&proof->pending);
+
+    mtx_destroy(&proof->lock);
+    cnd_destroy(&proof->cond);
+}
+
+//
+// Proof lines
+//
+
+// Start a clause addition (or deletion) line of at most the given number of literals.
+void PROOF_begin(PROOF* proof, bool deletion, size_t num_literals)
+{
+    if (proof->size + PROOF_LITERAL_SIZE * (num_literals + 2U) > PROOF_BUFFER_SIZE)
+    {
+        PROOF_flush(proof);
+    }
+
+    if (proof->binary)
+    {
+        proof->buffer[proof->size++] = deletion? 'd' : 'a';
+    }
+    else if (deletion)
+    {
+        proof->buffer[proof->size++] = 'd';
+        proof->buffer[proof->size++] = ' ';
+    }
+}
+
+void PROOF_literal(PROOF* proof, literal_t lit)
+{
+    unsigned value = LITERAL_VALUE_Get(lit);
+    if (proof->names != NULL)
+    {
+        value = proof->names[value];
+    }
+
+    bool negative  = (lit & LITERAL_CONTRARY_BIT) != 0U;
+
+    char* out = proof->buffer + proof->size;
+
+    if (proof->binary)
+    {
+        // Variable-length encoding of 2*var + sign, seven bits per byte:
+        unsigned encoded = 2U * value + negative;
+        while (encoded > 0x7FU)
+        {
+            *out++ = (char) (0x80U | (encoded & 0x7FU));
+            encoded >>= 7U;
+        }
+        *out++ = (char) encoded;
+    }
+    else
+    {
+        if (negative)
+        {
+            *out++ = '-';
+        }
+
+        char digits[8U];
+        unsigned num_digits = 0U;
+        do
+        {
+            digits[num_digits++] = (char) ('0' + value % 10U);
+            value /= 10U;
+        }
+        while (value != 0U);
+
+        while (num_digits != 0U)
+        {
+            *out++ = digits[--num_digits];
+        }
+
+        *out++ = ' ';
+    }
+
+    proof->size = out - proof->buffer;
+}
+
+// Terminate the line.
+void PROOF_end(PROOF* proof)
+{
+    if (proof->binary)
+    {
+        proof->buffer[proof->size++] = 0;
+    }
+    else
+    {
+        proof->buffer[proof->size++] = '0';
+        proof->buffer[proof->size++] = '\n';
+    }
+}
+
+void PROOF_clause(PROOF* proof, const CLAUSE* clause, bool deletion)
+{
+    PROOF_begin(proof, deletion, CLAUSE_size(clause));
+
+    for (size_t lit_i = 0U; lit_i < CLAUSE_size(clause); ++lit_i)
+    {
+        PROOF_literal(proof, CLAUSE_get(clause, lit_i));
+    }
+
+    PROOF_end(proof);
+}
+
+#endif // DPLL_PROOF_H
@@ -0,0 +1,321 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_REORDER_H
+#define DPLL_REORDER_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "utils.h"
+#include "formula.h"
+
+//======================//
+// Variable renumbering //
+//======================//
+
+// Variables sharing clauses are given close numbers, so that their bits in the variable sets,
+// their watch lists and their literal values share cache lines during the propagation.
+// Numbers are compacted: the variables of the formula are renamed to 1..num_variables.
+typedef enum
+{
+    REORDER_NONE,
+    // Order of the first occurrence in the clauses (as stored, shortest clauses first):
+    REORDER_FIRST_OCCURRENCE,
+    // Cuthill-McKee: breadth-first search of the variable interaction graph,
+    // neighbours are numbered in the order of increasing degree:
+    REORDER_CUTHILL_MCKEE
+} reorder_t;
+
+typedef struct
+{
+    // New number of every original variable (zero for the variables not in the formula):
+    uint16_t renamed[NUM_LITERALS];
+
+    // Original number of every new variable:
+    uint16_t original[NUM_LITERALS];
+
+    size_t num_variables;
+} RENUMBERING;
+
+// Parse the name of the order.
+//
+// Return false if there is no such order.
+bool REORDER_parse(reorder_t* order, const char* name)
+{
+    if (strcmp(name, "first") == 0)
+    {
+        *order = REORDER_FIRST_OCCURRENCE;
+        return true;
+    }
+
+    if (strcmp(name, "cm") == 0)
+    {
+        *order = REORDER_CUTHILL_MCKEE;
+        return true;
+    }
+
+    return false;
+}
+
+void RENUMBERING_number(RENUMBERING* renumbering, uint16_t var)
+{
+    renumbering->num_variables += 1U;
+
+    renumbering->renamed[var]                         = renumbering->num_variables;
+    renumbering->original[renumbering->num_variables] = var;
+}
+
+// Number the variables of every component breadth-first.
+// The search walks the variable-clause incidence, so that the interaction graph is never built:
+// a clause is expanded once, as all of its variables get numbered by the expansion.
+void RENUMBERING_cuthill_mckee(RENUMBERING* renumbering, const FORMULA* formula)
+{
+    size_t num_clauses = FORMULA_size(formula);
+
+    // Occurrence lists of the variables (degree is the number of occurrences):
+    uint32_t* occurs_start = calloc(NUM_LITERALS + 1U, sizeof(uint32_t));
+    VERIFY_CONTRACT(occurs_start != NULL,
+        "[%s] Unable to allocate occurrence lists\n", "RENUMBERING_cuthill_mckee");
+
+    for (size_t cls_i = 0U; cls_i < num_clauses; ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            occurs_start[LITERAL_VALUE_Get(CLAUSE_get(cls, lit_i)) + 1U] += 1U;
+        }
+    }
+
+    for (size_t var = 0U; var < NUM_LITERALS; ++var)
+    {
+        occurs_start[var + 1U] += occurs_start[var];
+    }
+
+    uint32_t* occurs   = malloc((occurs_start[NUM_LITERALS] + 1U) * sizeof(uint32_t));
+    uint32_t* fill     = malloc(NUM_LITERALS * sizeof(uint32_t));
+    bool*     expanded = calloc(num_clauses + 1U, sizeof(bool));
+    uint16_t* queue    = malloc(NUM_LITERALS * sizeof(uint16_t));
+    VERIFY_CONTRACT(occurs != NULL && fill != NULL && expanded != NULL && queue != NULL,
+        "[%s] Unable to allocate occurrence lists\n", "RENUMBERING_cuthill_mckee");
+
+    memcpy(fill, occurs_start, NUM_LITERALS * sizeof(uint32_t));
+    for (size_t cls_i = 0U; cls_i < num_clauses; ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            occurs[fill[LITERAL_VALUE_Get(CLAUSE_get(cls, lit_i))]++] = cls_i;
+        }
+    }
+
+    #define RENUMBERING_DEGREE(var) (occurs_start[(var) + 1U] - occurs_start[(var)])
+
+    size_t queue_head = 0U;
+    while (true)
+    {
+        // Every component starts from its variable of the smallest degree:
+        uint16_t start = 0U;
+        for (uint16_t var = 1U; var < NUM_LITERALS; ++var)
+        {
+            if (RENUMBERING_DEGREE(var) != 0U && renumbering->renamed[var] == 0U &&
+                (start == 0U || RENUMBERING_DEGREE(var) < RENUMBERING_DEGREE(start)))
+            {
+                start = var;
+            }
+        }
+
+        if (start == 0U)
+        {
+            break;
+        }
+
+        RENUMBERING_number(renumbering, start);
+        queue[renumbering->num_variables - 1U] = start;
+
+        for (; queue_head < renumbering->num_variables; ++queue_head)
+        {
+            uint16_t var = queue[queue_head];
+
+            size_t first_neighbour = renumbering->num_variables;
+
+            for (uint32_t occ_i = occurs_start[var]; occ_i < occurs_start[var + 1U]; ++occ_i)
+            {
+                uint32_t cls_i = occurs[occ_i];
+                if (expanded[cls_i])
+                {
+                    continue;
+                }
+
+                expanded[cls_i] = true;
+
+                const CLAUSE* cls = FORMULA_get(formula, cls_i);
+                for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+                {
+                    uint16_t neighbour = LITERAL_VALUE_Get(CLAUSE_get(cls, lit_i));
+                    if (renumbering->renamed[neighbour] == 0U)
+                    {
+                        RENUMBERING_number(renumbering, neighbour);
+                        queue[renumbering->num_variables - 1U] = neighbour;
+                    }
+                }
+            }
+
+            // Insertion sort of the new neighbours by degree (the lists are short):
+            for (size_t i = first_neighbour + 1U; i < renumbering->num_variables; ++i)
+            {
+                uint16_t neighbour = queue[i];
+
+                size_t j = i;
+                for (; j > first_neighbour &&
+                       RENUMBERING_DEGREE(queue[j - 1U]) > RENUMBERING_DEGREE(neighbour); --j)
+                {
+                    queue[j] = queue[j - 1U];
+                }
+
+                queue[j] = neighbour;
+            }
+
+            for (size_t i = first_neighbour; i < renumbering->num_variables; ++i)
+            {
+                renumbering->renamed[queue[i]]  = i + 1U;
+                renumbering->original[i + 1U] = queue[i];
+            }
+        }
+    }
+
+    #undef RENUMBERING_DEGREE
+
+    free(occurs_start);
+    free(occurs);
+    free(fill);
+    free(expanded);
+    free(queue);
+}
+
+// Compute the new numbers of the formula variables.
+void RENUMBERING_init(RENUMBERING* renumbering, const FORMULA* formula, reorder_t order)
+{
+    memset(renumbering->renamed,  0, sizeof(renumbering->renamed));
+    memset(renumbering->original, 0, sizeof(renumbering->original));
+    renumbering->num_variables = 0U;
+
+    if (order == REORDER_CUTHILL_MCKEE)
+    {
+        RENUMBERING_cuthill_mckee(renumbering, formula);
+        return;
+    }
+
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            uint16_t var = LITERAL_VALUE_Get(CLAUSE_get(cls, lit_i));
+
+            if (renumbering->renamed[var] == 0U)
+            {
+                RENUMBERING_number(renumbering, var);
+            }
+        }
+    }
+}
+
+literal_t RENUMBERING_rename(const RENUMBERING* renumbering, literal_t lit)
+{
+    LITERAL_VALUE_Set(lit, renumbering->renamed[LITERAL_VALUE_Get(lit)]);
+
+    return lit;
+}
+
+// Build the renamed copy of the formula.
+// Clauses of the same size are ordered by their smallest new variable,
+// so that the clauses watched by the neighbouring variables are stored close together.
+void RENUMBERING_apply(const RENUMBERING* renumbering, const FORMULA* formula, FORMULA* renamed)
+{
+    size_t num_clauses = FORMULA_size(formula);
+
+    // Counting sort of the clauses by the smallest new variable:
+    uint32_t* key_start = calloc(NUM_LITERALS + 1U, sizeof(uint32_t));
+    uint32_t* order     = malloc((num_clauses + 1U) * sizeof(uint32_t));
+    uint16_t* keys      = malloc((num_clauses + 1U) * sizeof(uint16_t));
+    VERIFY_CONTRACT(key_start != NULL && order != NULL && keys != NULL,
+        "[%s] Unable to allocate clause order of %zu clauses\n", "RENUMBERING_apply", num_clauses);
+
+    for (size_t cls_i = 0U; cls_i < num_clauses; ++cls_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        uint16_t key = NUM_LITERALS - 1U;
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            uint16_t var = renumbering->renamed[LITERAL_VALUE_Get(CLAUSE_get(cls, lit_i))];
+            if (var < key)
+            {
+                key = var;
+            }
+        }
+
+        keys[cls_i] = key;
+        key_start[key + 1U] += 1U;
+    }
+
+    for (size_t key = 0U; key < NUM_LITERALS; ++key)
+    {
+        key_start[key + 1U] += key_start[key];
+    }
+
+    for (size_t cls_i = 0U; cls_i < num_clauses; ++cls_i)
+    {
+        order[key_start[keys[cls_i]]++] = cls_i;
+    }
+
+    // NOTE: clauses of equal size keep the insertion order.
+    FORMULA_init(renamed);
+
+    for (size_t order_i = 0U; order_i < num_clauses; ++order_i)
+    {
+        const CLAUSE* cls = FORMULA_get(formula, order[order_i]);
+
+        CLAUSE copy;
+        CLAUSE_init(&copy);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            CLAUSE_insert(&copy, RENUMBERING_rename(renumbering, CLAUSE_get(cls, lit_i)));
+        }
+
+        FORMULA_insert(renamed, copy);
+    }
+
+    free(key_start);
+    free(order);
+    free(keys);
+}
+
+// Translate the assignment of the renamed formula back to the original variables.
+void RENUMBERING_restore(const RENUMBERING* renumbering, const VARIABLES* renamed, VARIABLES* original)
+{
+    VARIABLES_init(original);
+
+    for (size_t var = 1U; var <= renumbering->num_variables; ++var)
+    {
+        literal_t lit = 0U;
+        LITERAL_VALUE_Set(lit, var);
+
+        if (VARIABLES_literal_is_undef(renamed, lit))
+        {
+            continue;
+        }
+
+        literal_t restored = VARIABLES_literal_is_true(renamed, lit)? 0U : LITERAL_CONTRARY_BIT;
+        LITERAL_VALUE_Set(restored, renumbering->original[var]);
+
+        VARIABLES_assert_literal(original, restored);
+    }
+}
+
+#endif // DPLL_REORDER_H
@@ -0,0 +1,86 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_RNG_H
+#define DPLL_RNG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================//
+// Deterministic random numbers //
+//==============================//
+
+// Xoshiro256** generator seeded by SplitMix64.
+typedef struct
+{
+    uint64_t state[4U];
+} RNG;
+
+uint64_t RNG_splitmix(uint64_t* seed)
+{
+    uint64_t z = (*seed += 0x9E3779B97F4A7C15U);
+
+    z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9U;
+    z = (z ^ (z >> 27U)) * 0x94D049BB133111EBU;
+
+    return z ^ (z >> 31U);
+}
+
+void RNG_init(RNG* rng, uint64_t seed)
+{
+    for (unsigned i = 0U; i < 4U; ++i)
+    {
+        rng->state[i] = RNG_splitmix(&seed);
+    }
+}
+
+uint64_t RNG_rotl(uint64_t x, unsigned k)
+{
+    return (x << k) | (x >> (64U - k));
+}
+
+uint64_t RNG_next(RNG* rng)
+{
+    uint64_t* s = rng->state;
+
+    uint64_t result = RNG_rotl(s[1U] * 5U, 7U) * 9U;
+    uint64_t t = s[1U] << 17U;
+
+    s[2U] ^= s[0U];
+    s[3U] ^= s[1U];
+    s[1U] ^= s[2U];
+    s[0U] ^= s[3U];
+
+    s[2U] ^= t;
+    s[3U] = RNG_rotl(s[3U], 45U);
+
+    return result;
+}
+
+// Uniform number from [0, bound).
+uint64_t RNG_below(RNG* rng, uint64_t bound)
+{
+    // Reject the incomplete last range to avoid modulo bias:
+    uint64_t threshold = -bound % bound;
+
+    while (true)
+    {
+        uint64_t value = RNG_next(rng);
+        if (value >= threshold)
+        {
+            return value % bound;
+        }
+    }
+}
+
+// Uniform number from [0, 1).
+double RNG_real(RNG* rng)
+{
+    return (RNG_next(rng) >> 11U) * 0x1.0p-53;
+}
+
+bool RNG_bit(RNG* rng)
+{
+    return RNG_next(rng) >> 63U;
+}
+
+#endif // DPLL_RNG_H
@@ -0,0 +1,141 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_SCAN_H
+#define DPLL_SCAN_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <threads.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+#include "formula.h"
+
+//==========================//
+// Replacement watch search //
+//==========================//
+
+// Falsity of every literal is a byte indexed by the literal itself (without the decision bit):
+#define SCAN_NUM_VALUES (LITERAL_CONTRARY_BIT + NUM_LITERALS)
+
+// Gathers read four bytes starting at the byte of a literal:
+#define SCAN_VALUES_PADDING 4U
+
+// Clauses with fewer literals to scan are not worth a vector:
+#define SCAN_VECTOR_MIN 8U
+
+// Literals checked one by one before the vector scan:
+#define SCAN_PROBE 4U
+
+// Return the index of the first literal in [first, size) that is not false or size if there is none.
+typedef size_t (*scan_kernel_t)(const literal_t* literals, size_t first, size_t size, const uint8_t* falsified);
+
+size_t SCAN_scalar(const literal_t* literals, size_t first, size_t size, const uint8_t* falsified)
+{
+    for (size_t lit_i = first; lit_i < size; ++lit_i)
+    {
+        if (!falsified[literals[lit_i]])
+        {
+            return lit_i;
+        }
+    }
+
+    return size;
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+// Gather the falsity of 8 literals at once.
+__attribute__((target("avx2")))
+size_t SCAN_avx2(const literal_t* literals, size_t first, size_t size, const uint8_t* falsified)
+{
+    const __m256i low_byte = _mm256_set1_epi32(0xFF);
+
+    size_t lit_i = first;
+    for (; lit_i + 8U <= size; lit_i += 8U)
+    {
+        __m128i lits  = _mm_loadu_si128((const __m128i*) (literals + lit_i));
+        __m256i index = _mm256_cvtepu16_epi32(lits);
+
+        __m256i values = _mm256_i32gather_epi32((const int*) falsified, index, 1);
+        __m256i kept   = _mm256_cmpeq_epi32(_mm256_and_si256(values, low_byte), _mm256_setzero_si256());
+
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(kept));
+        if (mask != 0U)
+        {
+            return lit_i + __builtin_ctz(mask);
+        }
+    }
+
+    return SCAN_scalar(literals, lit_i, size, falsified);
+}
+
+// Gather the falsity of 16 literals at once.
+__attribute__((target("avx512f")))
+size_t SCAN_avx512(const literal_t* literals, size_t first, size_t size, const uint8_t* falsified)
+{
+    const __m512i low_byte = _mm512_set1_epi32(0xFF);
+
+    size_t lit_i = first;
+    for (; lit_i + 16U <= size; lit_i += 16U)
+    {
+        __m256i lits  = _mm256_loadu_si256((const __m256i*) (literals + lit_i));
+        __m512i index = _mm512_cvtepu16_epi32(lits);
+
+        __m512i values = _mm512_i32gather_epi32(index, falsified, 1);
+
+        unsigned mask = _mm512_testn_epi32_mask(values, low_byte);
+        if (mask != 0U)
+        {
+            return lit_i + __builtin_ctz(mask);
+        }
+    }
+
+    return SCAN_scalar(literals, lit_i, size, falsified);
+}
+#endif
+
+//
+// Kernel dispatch
+//
+
+scan_kernel_t SCAN_kernel = SCAN_scalar;
+once_flag     SCAN_once   = ONCE_FLAG_INIT;
+
+void SCAN_select_kernel(void)
+{
+    #if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        SCAN_kernel = SCAN_avx512;
+    }
+    else if (__builtin_cpu_supports("avx2"))
+    {
+        SCAN_kernel = SCAN_avx2;
+    }
+    #endif
+}
+
+// Pick the widest kernel supported by the processor (once per process).
+void SCAN_init(void)
+{
+    call_once(&SCAN_once, SCAN_select_kernel);
+}
+
+size_t SCAN_find(const literal_t* literals, size_t first, size_t size, const uint8_t* falsified)
+{
+    // The replacement is usually among the first literals:
+    size_t probe_end = (size - first < SCAN_VECTOR_MIN)? size : first + SCAN_PROBE;
+
+    size_t lit_i = SCAN_scalar(literals, first, probe_end, falsified);
+    if (lit_i < probe_end || probe_end == size)
+    {
+        return lit_i;
+    }
+
+    return SCAN_kernel(literals, probe_end, size, falsified);
+}
+
+#endif // DPLL_SCAN_H
@@ -0,0 +1,2114 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_SOLVER_H
+#define DPLL_SOLVER_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <signal.h>
+
+#include "formula.h"
+#include "memory.h"
+#include "proof.h"
+#include "profile.h"
+#include "local_search.h"
+#include "scan.h"
+#include "xor.h"
+#include "cardinality.h"
+
+#ifdef DPLL_ALLOC_GUARD
+#include "alloc_count.h"
+#endif
+
+// Convenient naming:
+typedef enum
+{
+    UNSAT = 0,
+    SAT   = 1,
+    UNDEF = 2
+} sat_t;
+
+//==========================//
+// Watch list implemetation //
+//==========================//
+
+#define DATA_T         const CLAUSE*
+#define DATA_STRUCTURE WATCHED_STORAGE
+#include "template_stack.h"
+
+bool CLAUSE_PTR_eq(const CLAUSE** el1, const CLAUSE** el2)
+{
+    return *el1 == *el2;
+}
+
+bool CLAUSE_PTR_lt(const CLAUSE** el1, const CLAUSE** el2)
+{
+    BUG_ON(false, "[%s] Invalid operation", "CLAUSE_PTR_lt");
+}
+
+typedef struct
+{
+    WATCHED_STORAGE* clause_lists;
+    size_t num_literals;
+
+    // Region the watch lists come from (NULL for the heap):
+    ARENA* arena;
+
+    // Size of the occurrence counters used on linking (measured in bytes):
+    size_t occurrence_bytes;
+} WATCH_LIST;
+
+void WATCH_LIST_init(WATCH_LIST* wl, size_t num_literals, ARENA* arena)
+{
+    wl->num_literals     = num_literals;
+    wl->arena            = arena;
+    wl->occurrence_bytes = 0U;
+
+    if (arena != NULL)
+    {
+        wl->clause_lists = ARENA_alloc(arena, 2U*num_literals * sizeof(WATCHED_STORAGE));
+    }
+    else
+    {
+        wl->clause_lists = calloc(2U*num_literals, sizeof(WATCHED_STORAGE));
+        VERIFY_CONTRACT(wl->clause_lists != NULL,
+            "[%s] Unable to allocate %zu watch lists\n", "WATCH_LIST_init", 2U*num_literals);
+    }
+
+    for (size_t i = 0U; i < 2U*num_literals; ++i)
+    {
+        if (arena != NULL)
+        {
+            WATCHED_STORAGE_init_arena(&wl->clause_lists[i], arena,
+                CLAUSE_PTR_eq, CLAUSE_PTR_lt, false);
+        }
+        else
+        {
+            WATCHED_STORAGE_init(&wl->clause_lists[i],
+                CLAUSE_PTR_eq, CLAUSE_PTR_lt, false);
+        }
+    }
+}
+
+WATCHED_STORAGE* WATCH_LIST_get(WATCH_LIST* wl, literal_t lit)
+{
+    size_t index = LITERAL_VALUE_Get(lit) - 1U;
+
+    if (lit & LITERAL_CONTRARY_BIT)
+    {
+        index += wl->num_literals;
+    }
+
+    return &wl->clause_lists[index];
+}
+
+void WATCH_LIST_link_initial(WATCH_LIST* wl, const FORMULA* formula)
+{
+    PROFILE_BEGIN(PROFILE_LINK_WATCHES);
+
+    // A literal is watched at most by the clauses it occurs in,
+    // so the watch lists are never reallocated during the search:
+    size_t* occurrences = calloc(2U*wl->num_literals, sizeof(size_t));
+    VERIFY_CONTRACT(occurrences != NULL,
+        "[%s] Unable to allocate occurrence counters\n", "WATCH_LIST_link_initial");
+
+    wl->occurrence_bytes = 2U*wl->num_literals * sizeof(size_t);
+
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            occurrences[WATCH_LIST_get(wl, CLAUSE_get(cls, lit_i)) - wl->clause_lists] += 1U;
+        }
+    }
+
+    // NOTE: lists linked again after the insertion of clauses grow geometrically,
+    //       so that the blocks they abandon in the arena stay proportional to the lists.
+    for (size_t i = 0U; i < 2U*wl->num_literals; ++i)
+    {
+        size_t capacity = wl->clause_lists[i].capacity;
+
+        WATCHED_STORAGE_reserve(&wl->clause_lists[i],
+            (occurrences[i] > capacity && occurrences[i] < 2U * capacity)? 2U * capacity : occurrences[i]);
+    }
+
+    free(occurrences);
+
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        // Add both wathes to watch initial watch lists:
+        literal_t watch1 = CLAUSE_watch1(cls);
+        literal_t watch2 = CLAUSE_watch2(cls);
+
+        WATCHED_STORAGE* wl1 = WATCH_LIST_get(wl, watch1);
+        WATCHED_STORAGE* wl2 = WATCH_LIST_get(wl, watch2);
+
+        if (!WATCHED_STORAGE_find(wl1, cls))
+        {
+            WATCHED_STORAGE_push(wl1, cls);
+        }
+
+        if (!WATCHED_STORAGE_find(wl2, cls))
+        {
+            WATCHED_STORAGE_push(wl2, cls);
+        }
+    }
+
+    PROFILE_END(PROFILE_LINK_WATCHES);
+}
+
+// Watch the first two literals of a clause added after the initial linking.
+void WATCH_LIST_link_clause(WATCH_LIST* wl, CLAUSE* cls)
+{
+    WATCHED_STORAGE_push(WATCH_LIST_get(wl, CLAUSE_watch1(cls)), cls);
+    WATCHED_STORAGE_push(WATCH_LIST_get(wl, CLAUSE_watch2(cls)), cls);
+}
+
+// Drop every watch (to be linked again).
+void WATCH_LIST_clear(WATCH_LIST* wl)
+{
+    for (size_t i = 0U; i < 2U*wl->num_literals; ++i)
+    {
+        wl->clause_lists[i].size = 0U;
+    }
+}
+
+void WATCH_LIST_set(WATCH_LIST* wl, literal_t lit, WATCHED_STORAGE ws)
+{
+    size_t index = LITERAL_VALUE_Get(lit) - 1U;
+
+    if (lit & LITERAL_CONTRARY_BIT)
+    {
+        index += wl->num_literals;
+    }
+
+    WATCHED_STORAGE_free(&wl->clause_lists[index]);
+
+    wl->clause_lists[index] = ws;
+}
+
+void WATCH_LIST_free(WATCH_LIST* wl)
+{
+    for (size_t i = 0U; i < 2U*wl->num_literals; ++i)
+    {
+        WATCHED_STORAGE_free(&wl->clause_lists[i]);
+    }
+
+    if (wl->arena == NULL)
+    {
+        free(wl->clause_lists);
+    }
+
+    wl->clause_lists = NULL;
+}
+
+void WATCH_LIST_print(WATCH_LIST* wl, const FORMULA* formula)
+{
+    for (size_t index = 0U; index < 2U * wl->num_literals; ++index)
+    {
+        int value = (index % wl->num_literals) + 1;
+        if (index >= wl->num_literals)
+        {
+            value *= -1;
+        }
+
+        WATCHED_STORAGE* ws = &wl->clause_lists[index];
+
+        if (ws->size == 0U)
+        {
+            continue;
+        }
+
+        printf("WL[%4d]", value);
+
+        for (size_t cls_i = 0U; cls_i < ws->size; ++cls_i)
+        {
+            // Fuck with the type system a bit more:
+            CLAUSE* cls = (CLAUSE*)(void*) WATCHED_STORAGE_get(ws, cls_i);
+
+            size_t cls_i = cls - formula->clauses.array;
+
+            printf(" %4zu", cls_i);
+        }
+
+        printf("\n");
+    }
+}
+
+//===================//
+// Search statistics //
+//===================//
+
+typedef struct {
+    uint64_t decisions;
+    uint64_t propagations;
+    uint64_t conflicts;
+    uint64_t backtracks;
+
+    // Clauses visited on watch list notification:
+    uint64_t watch_visits;
+
+    // Literals inspected in search for a new watch:
+    uint64_t clause_scans;
+
+    // Maximum number of literals in the trial:
+    uint64_t max_depth;
+
+    // Gauss-Jordan propagation of the XOR constraints:
+    uint64_t xor_rows;
+    uint64_t xor_propagations;
+    uint64_t xor_conflicts;
+
+    // Counter-based propagation of the cardinality constraints:
+    uint64_t cardinalities;
+    uint64_t cardinality_propagations;
+    uint64_t cardinality_conflicts;
+
+    // Greedy fills tried before the search (not counted as search decisions and conflicts):
+    uint64_t lucky_decisions;
+    uint64_t lucky_conflicts;
+
+    // Memory of the search state:
+    MEMORY_USAGE memory;
+} STATS;
+
+void STATS_init(STATS* stats)
+{
+    stats->decisions    = 0U;
+    stats->propagations = 0U;
+    stats->conflicts    = 0U;
+    stats->backtracks   = 0U;
+    stats->watch_visits = 0U;
+    stats->clause_scans = 0U;
+    stats->max_depth    = 0U;
+
+    stats->xor_rows         = 0U;
+    stats->xor_propagations = 0U;
+    stats->xor_conflicts    = 0U;
+
+    stats->cardinalities            = 0U;
+    stats->cardinality_propagations = 0U;
+    stats->cardinality_conflicts    = 0U;
+
+    stats->lucky_decisions = 0U;
+    stats->lucky_conflicts = 0U;
+
+    MEMORY_USAGE_init(&stats->memory);
+}
+
+// Print counters as space-separated name-value pairs.
+void STATS_print_values(const STATS* stats)
+{
+    printf("decisions %"PRIu64" propagations %"PRIu64" conflicts %"PRIu64" "
+        "backtracks %"PRIu64" watch_visits %"PRIu64" clause_scans %"PRIu64" max_depth %"PRIu64,
+        stats->decisions, stats->propagations, stats->conflicts,
+        stats->backtracks, stats->watch_visits, stats->clause_scans, stats->max_depth);
+}
+
+void STATS_print(const STATS* stats)
+{
+    printf("c ");
+    STATS_print_values(stats);
+    printf("\n");
+
+    if (stats->xor_rows != 0U)
+    {
+        printf("c xor rows %"PRIu64" propagations %"PRIu64" conflicts %"PRIu64"\n",
+            stats->xor_rows, stats->xor_propagations, stats->xor_conflicts);
+    }
+
+    if (stats->cardinalities != 0U)
+    {
+        printf("c cardinality constraints %"PRIu64" propagations %"PRIu64" conflicts %"PRIu64"\n",
+            stats->cardinalities, stats->cardinality_propagations, stats->cardinality_conflicts);
+    }
+
+    if (stats->lucky_decisions != 0U)
+    {
+        printf("c lucky decisions %"PRIu64" conflicts %"PRIu64"\n",
+            stats->lucky_decisions, stats->lucky_conflicts);
+    }
+
+    MEMORY_USAGE_print(&stats->memory);
+}
+
+//=============================//
+// Periodic progress reporting //
+//=============================//
+
+typedef struct {
+    // Report intervals (zero disables an interval):
+    uint64_t conflicts_interval;
+    double   seconds_interval;
+
+    // Thresholds for the next report:
+    uint64_t next_conflicts;
+    double   next_time;
+
+    double start;
+} PROGRESS;
+
+void PROGRESS_init(PROGRESS* progress, uint64_t conflicts_interval, double seconds_interval)
+{
+    progress->conflicts_interval = conflicts_interval;
+    progress->seconds_interval   = seconds_interval;
+
+    progress->start = TIME_now();
+
+    progress->next_conflicts = conflicts_interval;
+    progress->next_time      = progress->start + seconds_interval;
+}
+
+// Print a progress line once any of the report intervals has passed.
+void PROGRESS_update(PROGRESS* progress, const STATS* stats, uint32_t level)
+{
+    bool report = false;
+
+    if (progress->conflicts_interval != 0U && stats->conflicts >= progress->next_conflicts)
+    {
+        progress->next_conflicts = stats->conflicts + progress->conflicts_interval;
+        report = true;
+    }
+
+    double now = 0.0;
+    if (progress->seconds_interval > 0.0)
+    {
+        now = TIME_now();
+        if (now >= progress->next_time)
+        {
+            progress->next_time = now + progress->seconds_interval;
+            report = true;
+        }
+    }
+
+    if (!report)
+    {
+        return;
+    }
+
+    if (now == 0.0)
+    {
+        now = TIME_now();
+    }
+
+    printf("c progress time %.3f level %"PRIu32" ", now - progress->start, level);
+    STATS_print_values(stats);
+    printf("\n");
+
+    // Keep the reports visible when the output is piped:
+    fflush(stdout);
+}
+
+//=================//
+// Resource limits //
+//=================//
+
+// NOTE: zero stands for no limit.
+typedef struct {
+    // Resident memory of the process (measured in bytes):
+    size_t memory;
+
+    // Search budgets:
+    double   seconds;
+    uint64_t conflicts;
+    uint64_t decisions;
+    uint64_t propagations;
+
+    // Flag raised asynchronously to stop the search (if not NULL):
+    volatile sig_atomic_t* interrupted;
+} LIMITS;
+
+void LIMITS_init(LIMITS* limits)
+{
+    limits->memory = 0U;
+
+    limits->seconds      = 0.0;
+    limits->conflicts    = 0U;
+    limits->decisions    = 0U;
+    limits->propagations = 0U;
+
+    limits->interrupted = NULL;
+}
+
+// Check whether any search budget is exhausted.
+bool LIMITS_reached(const LIMITS* limits, const STATS* stats, double deadline)
+{
+    if (limits == NULL)
+    {
+        return false;
+    }
+
+    if (limits->interrupted != NULL && *limits->interrupted)
+    {
+        return true;
+    }
+
+    if ((limits->conflicts    != 0U && stats->conflicts    >= limits->conflicts) ||
+        (limits->decisions    != 0U && stats->decisions    >= limits->decisions) ||
+        (limits->propagations != 0U && stats->propagations >= limits->propagations))
+    {
+        return true;
+    }
+
+    return limits->seconds > 0.0 && TIME_now() >= deadline;
+}
+
+//==============================//
+// Local search phase selection //
+//==============================//
+
+// Decisions take the polarity of the best assignment found by local search bursts.
+// One burst runs after the preprocessing, the following ones every conflicts_interval conflicts.
+typedef struct {
+    // Flips of every burst:
+    uint64_t flips;
+
+    // Conflicts between the bursts (zero for a single burst):
+    uint64_t conflicts_interval;
+
+    uint64_t seed;
+
+    // Local search over the preprocessed formula:
+    LOCAL_SEARCH ls;
+    bool started;
+
+    // Threshold for the next burst:
+    uint64_t next_conflicts;
+
+    // Statistics:
+    uint64_t bursts;
+    size_t   initial_unsat;
+} PHASES;
+
+void PHASES_init(PHASES* phases, uint64_t flips, uint64_t conflicts_interval, uint64_t seed)
+{
+    phases->flips              = flips;
+    phases->conflicts_interval = conflicts_interval;
+    phases->seed               = seed;
+
+    phases->started        = false;
+    phases->next_conflicts = 0U;
+    phases->bursts         = 0U;
+    phases->initial_unsat  = 0U;
+}
+
+void PHASES_print(const PHASES* phases)
+{
+    if (!phases->started)
+    {
+        printf("c phase bursts 0\n");
+        return;
+    }
+
+    printf("c phase bursts %"PRIu64" flips %"PRIu64" unsat %zu -> %zu\n",
+        phases->bursts, phases->ls.flips, phases->initial_unsat, phases->ls.best_unsat);
+}
+
+//================================//
+// Assertion trial data structure //
+//================================//
+
+typedef struct {
+    // Asserted literals:
+    LIT_STORAGE literals;
+    LIT_STORAGE assertion_queue;
+
+    // Current level:
+    uint32_t level;
+
+    // Variables used in current trial:
+    VARIABLES variables;
+
+    // Variables not used in current trial:
+    VARIABLES unselected;
+
+    // Byte per literal that is non-zero for the false literals
+    // (mirrors the variables for the replacement watch search):
+    uint8_t* falsified;
+
+    // Flag used to check for unsatisfyibility:
+    bool conflict_flag;
+
+    // Watch list:
+    WATCH_LIST wl;
+
+    // Search statistics:
+    STATS stats;
+
+    // Region the search state comes from (NULL for the heap):
+    ARENA* arena;
+
+    // Proof of unsatisfiability (NULL if not logged):
+    PROOF* proof;
+
+    // XOR constraints of the formula (NULL if not propagated):
+    XOR_SYSTEM* xors;
+
+    // Cardinality constraints of the formula (NULL if there are none):
+    CARDINALITY_SYSTEM* cardinalities;
+
+    // Preferred polarity of variables 1..num_phases (NULL for the watch-based polarity):
+    const bool* phases;
+    size_t num_phases;
+} TRIAL;
+
+void TRIAL_init(TRIAL* trial, size_t num_literals, ARENA* arena)
+{
+    if (arena != NULL)
+    {
+        LIT_STORAGE_init_arena(&trial->literals,        arena, &LITERAL_eq_contrarity, &LITERAL_lt, false);
+        LIT_STORAGE_init_arena(&trial->assertion_queue, arena, &LITERAL_eq_contrarity, &LITERAL_lt, false);
+    }
+    else
+    {
+        LIT_STORAGE_init(
+            &trial->literals,
+            &LITERAL_eq_contrarity,
+            &LITERAL_lt,
+            false);
+
+        LIT_STORAGE_init(
+            &trial->assertion_queue,
+            &LITERAL_eq_contrarity,
+            &LITERAL_lt,
+            false);
+    }
+
+    // Every variable is asserted at most once,
+    // the queue holds at most both literals of every variable:
+    LIT_STORAGE_reserve(&trial->literals,        num_literals);
+    LIT_STORAGE_reserve(&trial->assertion_queue, 2U*num_literals);
+
+    trial->level = 0U;
+
+    VARIABLES_init(&trial->variables);
+    VARIABLES_init(&trial->unselected);
+
+    size_t falsified_size = SCAN_NUM_VALUES + SCAN_VALUES_PADDING;
+    trial->falsified = (arena != NULL)?
+        ARENA_calloc(arena, falsified_size, sizeof(uint8_t)) :
+        calloc(falsified_size, sizeof(uint8_t));
+    VERIFY_CONTRACT(trial->falsified != NULL,
+        "[%s] Unable to allocate literal values\n", "TRIAL_init");
+
+    SCAN_init();
+
+    trial->conflict_flag = false;
+
+    WATCH_LIST_init(&trial->wl, num_literals, arena);
+
+    STATS_init(&trial->stats);
+
+    trial->arena = arena;
+    trial->proof = NULL;
+    trial->xors  = NULL;
+
+    trial->cardinalities = NULL;
+
+    trial->phases     = NULL;
+    trial->num_phases = 0U;
+}
+
+void TRIAL_free(TRIAL* trial)
+{
+    LIT_STORAGE_free(&trial->literals);
+    LIT_STORAGE_free(&trial->assertion_queue);
+    WATCH_LIST_free(&trial->wl);
+
+    if (trial->arena == NULL)
+    {
+        free(trial->falsified);
+    }
+}
+
+void TRIAL_print(TRIAL* trial)
+{
+    for (size_t lit_i = 0U; lit_i < trial->literals.size; ++lit_i)
+    {
+        literal_t lit = LIT_STORAGE_get(&trial->literals, lit_i);
+
+        printf("%5d ", LITERAL_value(lit));
+    }
+
+    printf("\n");
+}
+
+// Current level for a trial - number of decision literals in it.
+// trial_cur_level(trial) = length(trial_decisions(trial))
+uint32_t TRIAL_cur_level(const TRIAL* trial)
+{
+    return trial->level;
+}
+
+bool TRIAL_literal_is_true(const TRIAL* trial, literal_t lit)
+{
+    return trial->falsified[(lit & ~LITERAL_DECISION_BIT) ^ LITERAL_CONTRARY_BIT];
+}
+
+bool TRIAL_literal_is_false(const TRIAL* trial, literal_t lit)
+{
+    return trial->falsified[lit & ~LITERAL_DECISION_BIT];
+}
+
+// Record the assignment of the literal in the variables and the literal values.
+void TRIAL_set_literal(TRIAL* trial, literal_t lit)
+{
+    VARIABLES_assert_literal(&trial->variables, lit);
+
+    trial->falsified[(lit & ~LITERAL_DECISION_BIT) ^ LITERAL_CONTRARY_BIT] = 1U;
+
+    if (trial->xors != NULL)
+    {
+        XOR_SYSTEM_assign(trial->xors, lit);
+    }
+
+    if (trial->cardinalities != NULL)
+    {
+        CARDINALITY_SYSTEM_assign(trial->cardinalities, lit);
+    }
+}
+
+void TRIAL_unset_literal(TRIAL* trial, literal_t lit)
+{
+    VARIABLES_remove_literal(&trial->variables, lit);
+
+    trial->falsified[(lit & ~LITERAL_DECISION_BIT) ^ LITERAL_CONTRARY_BIT] = 0U;
+
+    if (trial->xors != NULL)
+    {
+        XOR_SYSTEM_unassign(trial->xors, lit);
+    }
+
+    if (trial->cardinalities != NULL)
+    {
+        CARDINALITY_SYSTEM_unassign(trial->cardinalities, lit);
+    }
+}
+
+bool TRIAL_literal_is_undef(const TRIAL* trial, literal_t lit)
+{
+    return VARIABLES_literal_is_undef(&trial->variables, lit);
+}
+
+void TRIAL_add_to_assertion_queue(TRIAL* trial, literal_t literal)
+{
+    if (!LIT_STORAGE_find(&trial->assertion_queue, literal))
+    {
+        // Enqueue literal:
+        LIT_STORAGE_insert(&trial->assertion_queue, literal, 0U);
+    }
+}
+
+// Checks whether a given assertion trial unsatisfies a formula:
+bool TRIAL_formula_is_unsat(const TRIAL* trial)
+{
+    #ifndef NDEBUG
+    printf("[CHECK SAT ] Trial is %s\n", trial->conflict_flag? "UNSAT" : "SAT");
+    #endif
+
+    return trial->conflict_flag;
+}
+
+// Assert an assumption literal before the formula is preprocessed.
+// NOTE: watch lists are not linked yet, so no notification is required.
+//
+// Return false if the assumption contradicts the trial.
+bool TRIAL_assume(TRIAL* trial, literal_t literal)
+{
+    literal &= ~LITERAL_DECISION_BIT;
+
+    if (TRIAL_literal_is_false(trial, literal))
+    {
+        return false;
+    }
+
+    if (TRIAL_literal_is_undef(trial, literal))
+    {
+        LIT_STORAGE_push(&trial->literals, literal);
+
+        TRIAL_set_literal(trial, literal);
+        VARIABLES_remove_literal(&trial->unselected, literal);
+    }
+
+    return true;
+}
+
+void TRIAL_pop_to_last_decision(TRIAL* trial, literal_t* literal)
+{
+    PROFILE_CYCLES_BEGIN(PROFILE_POP_TO_DECISION);
+
+    bool ret;
+    do
+    {
+        literal_t dumpster;
+        ret = LIT_STORAGE_pop(&trial->assertion_queue, &dumpster);
+    }
+    while (ret);
+
+    do
+    {
+        bool ret = LIT_STORAGE_pop(&trial->literals, literal);
+        BUG_ON(!ret, "[%s] Expected at least one decision literal!", "trial_pop_to_last_decision");
+
+        TRIAL_unset_literal(trial, *literal);
+        VARIABLES_assert_literal(&trial->unselected, *literal);
+    }
+    while (!(*literal & LITERAL_DECISION_BIT));
+
+    trial->level -= 1U;
+
+    PROFILE_CYCLES_END(PROFILE_POP_TO_DECISION);
+}
+
+//================//
+// DPLL algorithm //
+//================//
+
+//
+// Debugging utility
+//
+#define RED     "\033[1;31m"
+#define GREEN   "\033[1;32m"
+#define YELLOW  "\033[1;33m"
+#define MAGENTA "\033[1;35m"
+#define RESET   "\033[0m"
+
+void dpll_print_progress(TRIAL* trial, FORMULA* formula)
+{
+    TRIAL_print(trial);
+
+    printf("[TO ASSERT ] ");
+    for (size_t lit_i = 0U; lit_i < trial->assertion_queue.size; ++lit_i)
+    {
+        literal_t lit = LIT_STORAGE_get(&trial->assertion_queue, lit_i);
+
+        printf(YELLOW"%5d ", LITERAL_value(lit));
+    }
+    printf("\n"RESET);
+
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        printf("[CLAUSE %3zu] ", cls_i);
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(cls); ++lit_i)
+        {
+            literal_t lit = CLAUSE_get(cls, lit_i);
+
+            const char* color = TRIAL_literal_is_false(trial, lit)? RED    :
+                                TRIAL_literal_is_true(trial, lit) ? GREEN  :
+                                                                    MAGENTA;
+
+            printf("%s%5d ", color, LITERAL_value(lit));
+        }
+
+        printf("\n"RESET);
+    }
+}
+
+//
+// Literal assertion
+//
+
+void dpll_notify_watches(TRIAL* trial, FORMULA* formula, literal_t literal)
+{
+    // NOTE: literal is the inversion of the asserted literal
+
+    PROFILE_CYCLES_BEGIN(PROFILE_NOTIFY_WATCHES);
+
+    // Get current watch list to work with:
+    WATCHED_STORAGE* ws = WATCH_LIST_get(&trial->wl, literal);
+
+    // The watch list is compacted in place:
+    // the clauses that keep the watch are moved to its beginning.
+    size_t num_kept = 0U;
+
+    trial->stats.watch_visits += ws->size;
+
+    for (size_t cls_i = 0U; cls_i < ws->size; ++cls_i)
+    {
+        // Fuck with the type system a bit:
+        CLAUSE* cls = (CLAUSE*)(void*) WATCHED_STORAGE_get(ws, cls_i);
+
+        // Check whether a watched literal is falsified:
+        BUG_ON(CLAUSE_watch1(cls) != literal && CLAUSE_watch2(cls) != literal,
+            "[dpll_notify_watches] Watchlist invariant is broken for clause #%zu",
+            cls_i);
+
+        // Ensure that second literal is falsified:
+        if (CLAUSE_watch1(cls) == literal)
+        {
+            CLAUSE_swap_watches(cls);
+        }
+
+        // At this point:
+        // watch1 = UNDEF/FALSE/TRUE
+        // watch2 = FALSE
+        // Case of  TRUE/FALSE is a true clause => no notification
+        if (TRIAL_literal_is_true(trial, CLAUSE_watch1(cls)))
+        {
+            // Keep clause in the watch list:
+            ws->array[num_kept++] = cls;
+
+            continue;
+        }
+
+        // At this point:
+        // watch1 = FALSE/UNDEF
+        // watch2 = FALSE
+
+        // Find first non-watched unfalsified literal:
+        size_t size  = CLAUSE_size(cls);
+        size_t lit_i = SCAN_find(cls->literals.array, 2U, size, trial->falsified);
+
+        // Count the literals inspected up to the replacement:
+        trial->stats.clause_scans += (lit_i < size)? lit_i - 1U : size - 2U;
+
+        if (lit_i < size)
+        {
+            literal_t lit = CLAUSE_get(cls, lit_i);
+
+            // Update watched literal:
+            CLAUSE_set_watch2(cls, lit_i);
+
+            // Add clause to watch list of the new watched literal:
+            // NOTE: this possibly removes the clause from the watch list wl
+            WATCHED_STORAGE* ws_other = WATCH_LIST_get(&trial->wl, lit);
+
+            if (!WATCHED_STORAGE_find(ws_other, cls))
+            {
+                WATCHED_STORAGE_push(ws_other, cls);
+            }
+
+            // Set watches to state:
+            // watch1 = FALSE/UNDEF
+            // watch2 = UNDEF
+            continue;
+        }
+
+        // At this point the clause state is:
+        // watch1 = FALSE/UNDEF
+        // watch2 = FALSE
+        // other  = FALSE
+        if (TRIAL_literal_is_false(trial, CLAUSE_watch1(cls)))
+        {
+            // Detect a falsified clause:
+            trial->conflict_flag = true;
+
+            // Keep clause in the watch list:
+            ws->array[num_kept++] = cls;
+        }
+        else
+        {
+            // Add unit clause to unit-propagation queue:
+            TRIAL_add_to_assertion_queue(trial, CLAUSE_watch1(cls));
+
+            // Keep clause in the watch list:
+            ws->array[num_kept++] = cls;
+        }
+    }
+
+    // Drop the clauses that moved to other watch lists:
+    ws->size = num_kept;
+
+    PROFILE_CYCLES_END(PROFILE_NOTIFY_WATCHES);
+
+    #ifndef NDEBUG
+    printf(YELLOW"[WATCH %d]\n"RESET, LITERAL_value(literal));
+    WATCH_LIST_print(&trial->wl, formula);
+    #endif
+}
+
+// Falsify the unassigned literals of the cardinality constraints brought to their bounds by the literal.
+void dpll_notify_cardinalities(TRIAL* trial, literal_t literal)
+{
+    const CARDINALITY_SYSTEM* cs = trial->cardinalities;
+
+    for (uint32_t occ_i = cs->occurs_start[literal]; occ_i < cs->occurs_start[literal + 1U]; ++occ_i)
+    {
+        uint32_t card_i = cs->occurs[occ_i];
+
+        // NOTE: the literal is already counted.
+        if (cs->num_true[card_i] < cs->bounds[card_i])
+        {
+            continue;
+        }
+
+        if (cs->num_true[card_i] > cs->bounds[card_i])
+        {
+            trial->conflict_flag = true;
+            trial->stats.cardinality_conflicts += 1U;
+
+            return;
+        }
+
+        for (uint32_t lit_i = cs->start[card_i]; lit_i < cs->start[card_i + 1U]; ++lit_i)
+        {
+            literal_t lit = cs->literals[lit_i];
+
+            if (TRIAL_literal_is_undef(trial, lit))
+            {
+                TRIAL_add_to_assertion_queue(trial, lit ^ LITERAL_CONTRARY_BIT);
+                trial->stats.cardinality_propagations += 1U;
+            }
+        }
+    }
+}
+
+void dpll_assert_literal(TRIAL* trial, FORMULA* formula, literal_t literal)
+{
+    // Put decision into the literal:
+    LIT_STORAGE_push(&trial->literals, literal);
+
+    if (trial->literals.size > trial->stats.max_depth)
+    {
+        trial->stats.max_depth = trial->literals.size;
+    }
+
+    if (literal & LITERAL_DECISION_BIT)
+    {
+        trial->level += 1U;
+    }
+
+    TRIAL_set_literal(trial, literal);
+    VARIABLES_remove_literal(&trial->unselected, literal);
+
+    // Ignore the decision bit for the notification:
+    literal &= ~LITERAL_DECISION_BIT;
+
+    dpll_notify_watches(trial, formula, literal ^ LITERAL_CONTRARY_BIT);
+
+    if (trial->cardinalities != NULL)
+    {
+        dpll_notify_cardinalities(trial, literal);
+    }
+
+    // printf(YELLOW"[ASSERT %3d] "RESET, LITERAL_value(literal));
+    // dpll_print_progress(trial, formula);
+
+    // printf(YELLOW"[NOTIFY %3d] "RESET, -LITERAL_value(literal));
+    // dpll_print_progress(trial, formula);
+}
+
+//
+// Unit propagation
+//
+bool dpll_apply_unit_propagate(TRIAL* trial, FORMULA* formula)
+{
+    if (trial->assertion_queue.size != 0U)
+    {
+        literal_t lit;
+        LIT_STORAGE_pop(&trial->assertion_queue, &lit);
+
+        dpll_assert_literal(trial, formula, lit);
+        trial->stats.propagations += 1U;
+        return true;
+    }
+
+    return false;
+}
+
+// Propagate the XOR constraints under the assignment closed by the clause propagation.
+//
+// Return true if some literals are implied.
+bool dpll_xor_propagate(TRIAL* trial)
+{
+    if (!XOR_SYSTEM_propagate(trial->xors))
+    {
+        trial->conflict_flag = true;
+        trial->stats.xor_conflicts += 1U;
+
+        return false;
+    }
+
+    for (size_t lit_i = 0U; lit_i < trial->xors->num_implied; ++lit_i)
+    {
+        TRIAL_add_to_assertion_queue(trial, trial->xors->implied[lit_i]);
+    }
+
+    trial->stats.xor_propagations += trial->xors->num_implied;
+
+    return trial->xors->num_implied != 0U;
+}
+
+void dpll_exhaustive_unit_propagate(TRIAL* trial, FORMULA* formula)
+{
+    PROFILE_BEGIN(PROFILE_PROPAGATE);
+
+    // The XOR constraints are propagated once the clauses are:
+    do
+    {
+        bool ret;
+        do
+        {
+            ret = dpll_apply_unit_propagate(trial, formula);
+        }
+        while (!TRIAL_formula_is_unsat(trial) && ret != false);
+    }
+    while (!TRIAL_formula_is_unsat(trial) && trial->xors != NULL && dpll_xor_propagate(trial));
+
+    PROFILE_END(PROFILE_PROPAGATE);
+}
+
+//
+// Formula preprocessing
+//
+
+// Initialize the formula in the memory of the trial.
+void dpll_formula_init(FORMULA* formula, const TRIAL* trial)
+{
+    if (trial->arena != NULL)
+    {
+        FORMULA_init_arena(formula, trial->arena);
+    }
+    else
+    {
+        FORMULA_init(formula);
+    }
+}
+
+sat_t dpll_preprocess_formula(const FORMULA* initial, FORMULA* resulting, TRIAL* trial)
+{
+    bool rebuild;
+    do
+    {
+        rebuild = false;
+
+        // Initialize the resulting formula:
+        dpll_formula_init(resulting, trial);
+
+        for (size_t cls_i = 0U; cls_i < FORMULA_size(initial); cls_i++)
+        {
+            // Clause to be preprocessed:
+            // (Fuck the type system a bit)
+            CLAUSE* clause = FORMULA_get(initial, cls_i);
+
+            // Preprocessed clause to be inserted:
+            CLAUSE rslt_clause;
+            if (trial->arena != NULL)
+            {
+                CLAUSE_init_arena(&rslt_clause, trial->arena);
+            }
+            else
+            {
+                CLAUSE_init(&rslt_clause);
+            }
+
+            // Iterate over literals of a clause and copy them to rslt_clause:
+            bool insert_clause = true;
+            for (size_t lit_i = 0U; lit_i < CLAUSE_size(clause); lit_i++)
+            {
+                literal_t cur = CLAUSE_get(clause, lit_i);
+
+                // Do not copy falsified literal:
+                if (TRIAL_literal_is_false(trial, cur))
+                {
+                    continue;
+                }
+
+                // Remove already satisfied clause:
+                if (TRIAL_literal_is_true(trial, cur))
+                {
+                    insert_clause = false;
+                    break;
+                }
+
+                // Handle duplicates and tautology:
+                if (CLAUSE_find(&rslt_clause, cur))
+                {
+                    // Detect clause tautology:
+                    if (CLAUSE_find(&rslt_clause, cur ^ LITERAL_CONTRARY_BIT))
+                    {
+                        // Remove tautological clause:
+                        insert_clause = false;
+                        break;
+                    }
+
+                    // Do not copy duplicate literals:
+                    continue;
+                }
+
+                // Add literal to the clause:
+                CLAUSE_insert(&rslt_clause, cur);
+
+                // Also allow it to be the decision literal in the future:
+                VARIABLES_assert_literal(&trial->unselected, cur);
+            }
+
+            // Handle non-inserted clause:
+            if (!insert_clause)
+            {
+                CLAUSE_free(&rslt_clause);
+                continue;
+            }
+
+            // Detect UNSAT:
+            if (CLAUSE_size(&rslt_clause) == 0U)
+            {
+                CLAUSE_free(&rslt_clause);
+                return UNSAT;
+            }
+
+            // Assert obvious literal:
+            if (CLAUSE_size(&rslt_clause) == 1U)
+            {
+                dpll_assert_literal(trial, resulting, CLAUSE_get(&rslt_clause, 0U));
+                dpll_exhaustive_unit_propagate(trial, resulting);
+
+                CLAUSE_free(&rslt_clause);
+
+                // The new unit may falsify literals of clauses that are already copied.
+                // Such clauses are not notified through the watch lists,
+                // so the formula is rebuilt from scratch under the extended trial:
+                if (FORMULA_size(resulting) != 0U)
+                {
+                    rebuild = true;
+                    break;
+                }
+
+                continue;
+            }
+
+            // NOTE: it is guaranteed that size(rslt_clause) >= 2
+            FORMULA_insert(resulting, rslt_clause);
+        }
+
+        if (rebuild)
+        {
+            FORMULA_free(resulting);
+        }
+    }
+    while (rebuild);
+
+    if (FORMULA_size(resulting) == 0U)
+    {
+        return SAT;
+    }
+
+    // Initialize watch list:
+    WATCH_LIST_link_initial(&trial->wl, resulting);
+
+    return UNDEF;
+}
+
+//
+// Branching scheme
+//
+
+// Give the selected literal its preferred polarity.
+literal_t dpll_select_phase(const TRIAL* trial, literal_t lit)
+{
+    size_t var = LITERAL_VALUE_Get(lit);
+    if (trial->phases == NULL || var == 0U || var > trial->num_phases)
+    {
+        return lit;
+    }
+
+    return (lit & ~LITERAL_CONTRARY_BIT) | (trial->phases[var]? 0U : LITERAL_CONTRARY_BIT);
+}
+
+literal_t dpll_select_literal(TRIAL* trial, const FORMULA* formula)
+{
+    // Iterate over the formula from least clauses to bigger:
+    literal_t selected = LITERAL_NULL;
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        CLAUSE* cls = FORMULA_get(formula, cls_i);
+
+        // Check only the watches:
+        literal_t watch1 = CLAUSE_watch1(cls);
+        literal_t watch2 = CLAUSE_watch2(cls);
+
+        if (TRIAL_literal_is_undef(trial, watch1))
+        {
+            selected = watch1 ^ LITERAL_CONTRARY_BIT;
+            break;
+        }
+
+        if (TRIAL_literal_is_undef(trial, watch2))
+        {
+            selected = watch2 ^ LITERAL_CONTRARY_BIT;
+            break;
+        }
+    }
+
+    if (selected != LITERAL_NULL)
+    {
+        VARIABLES_remove_literal(&trial->unselected, selected);
+        return dpll_select_phase(trial, selected);
+    }
+
+    return dpll_select_phase(trial, VARIABLES_pop_asserted(&trial->unselected));
+}
+
+void dpll_apply_decide(TRIAL* trial, FORMULA* formula)
+{
+    PROFILE_BEGIN(PROFILE_DECIDE);
+
+    PROFILE_CYCLES_BEGIN(PROFILE_SELECT_LITERAL);
+
+    literal_t branching_literal =
+        dpll_select_literal(trial, formula);
+
+    PROFILE_CYCLES_END(PROFILE_SELECT_LITERAL);
+
+    BUG_ON(branching_literal == LITERAL_NULL,
+        "[%s] Termination not detected\n", "dpll_apply_decide");
+
+    dpll_assert_literal(trial, formula, branching_literal | LITERAL_DECISION_BIT);
+    trial->stats.decisions += 1U;
+
+    #ifndef NDEBUG
+    printf(YELLOW"[DECIDE %3d] "RESET, LITERAL_value(branching_literal));
+    TRIAL_print(trial);
+    #endif
+
+    PROFILE_END(PROFILE_DECIDE);
+}
+
+//
+// Backtracking scheme
+//
+void dpll_apply_backtrack(TRIAL* trial, FORMULA* formula)
+{
+    PROFILE_BEGIN(PROFILE_BACKTRACK);
+
+    // Pop everything to last decision literal:
+    literal_t last_decision;
+
+    TRIAL_pop_to_last_decision(trial, &last_decision);
+    trial->stats.backtracks += 1U;
+
+    // Hopefully eliminate conflict:
+    trial->conflict_flag = false;
+
+    // Assert literal with reversed contrarity as non-decision:
+    last_decision ^=  LITERAL_CONTRARY_BIT;
+    last_decision &= ~LITERAL_DECISION_BIT;
+
+    dpll_assert_literal(trial, formula, last_decision);
+
+    PROFILE_END(PROFILE_BACKTRACK);
+}
+
+// Undo every decision above the given level.
+void dpll_backtrack_to_level(TRIAL* trial, uint32_t level)
+{
+    while (TRIAL_cur_level(trial) > level)
+    {
+        literal_t dumpster;
+        TRIAL_pop_to_last_decision(trial, &dumpster);
+    }
+
+    trial->conflict_flag = false;
+}
+
+//
+// Proof logging
+//
+
+// Log the clause refuting the current decisions.
+// The clause is RUP: the decisions lead to the conflict by unit propagation,
+// the flipped decisions being implied by the clauses logged on the deeper levels.
+// NOTE: the clauses logged on the deeper levels are subsumed by the new one, so they are deleted.
+//       The pending clauses are stored in the proof, every clause followed by its size.
+void dpll_proof_conflict(TRIAL* trial)
+{
+    PROOF* proof = trial->proof;
+    LIT_STORAGE* pending = &proof->pending;
+
+    uint32_t level = TRIAL_cur_level(trial);
+
+    PROOF_begin(proof, false /*deletion*/, level);
+
+    for (size_t lit_i = 0U; lit_i < trial->literals.size; ++lit_i)
+    {
+        literal_t lit = trial->literals.array[lit_i];
+        if (lit & LITERAL_DECISION_BIT)
+        {
+            PROOF_literal(proof, (lit ^ LITERAL_CONTRARY_BIT) & ~LITERAL_DECISION_BIT);
+        }
+    }
+
+    PROOF_end(proof);
+
+    while (pending->size != 0U && pending->array[pending->size - 1U] > level)
+    {
+        size_t size  = pending->array[pending->size - 1U];
+        size_t start = pending->size - 1U - size;
+
+        PROOF_begin(proof, true /*deletion*/, size);
+
+        for (size_t lit_i = start; lit_i < start + size; ++lit_i)
+        {
+            PROOF_literal(proof, pending->array[lit_i]);
+        }
+
+        PROOF_end(proof);
+
+        pending->size = start;
+    }
+
+    // The refutation of level zero ends the proof:
+    if (level == 0U)
+    {
+        return;
+    }
+
+    for (size_t lit_i = 0U; lit_i < trial->literals.size; ++lit_i)
+    {
+        literal_t lit = trial->literals.array[lit_i];
+        if (lit & LITERAL_DECISION_BIT)
+        {
+            LIT_STORAGE_push(pending, (lit ^ LITERAL_CONTRARY_BIT) & ~LITERAL_DECISION_BIT);
+        }
+    }
+
+    LIT_STORAGE_push(pending, level);
+}
+
+// Bound the size of the pending clauses, so that the proof logging performs no allocations.
+// Every pending clause of level l justifies a flipped decision still on the trial at level l - 1,
+// it takes at most D + 2 entries with D decisions on the trial. With k pending clauses k + D <= V,
+// so the clauses take at most k (V - k + 2) <= (V + 2)^2 / 4 entries.
+size_t dpll_proof_pending_capacity(size_t num_variables)
+{
+    return (num_variables + 2U) * (num_variables + 2U) / 4U + 1U;
+}
+
+// Log the preprocessing of the formula under the level-zero trial:
+// units, strengthened clauses replacing the initial ones, deletion of satisfied and tautological clauses.
+void dpll_proof_preprocess(PROOF* proof, const FORMULA* initial, const TRIAL* trial, sat_t sat_flag)
+{
+    if (sat_flag == UNSAT)
+    {
+        PROOF_begin(proof, false /*deletion*/, 0U);
+        PROOF_end(proof);
+        return;
+    }
+
+    // Units go first, so that they stay implied when their reasons are deleted:
+    for (size_t lit_i = 0U; lit_i < trial->literals.size; ++lit_i)
+    {
+        PROOF_begin(proof, false /*deletion*/, 1U);
+        PROOF_literal(proof, trial->literals.array[lit_i] & ~LITERAL_DECISION_BIT);
+        PROOF_end(proof);
+    }
+
+    // Literals met in the current clause:
+    VARIABLES seen;
+    VARIABLES_init(&seen);
+
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(initial); ++cls_i)
+    {
+        const CLAUSE* clause = FORMULA_get(initial, cls_i);
+
+        bool satisfied    = false;
+        bool strengthened = false;
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(clause); ++lit_i)
+        {
+            literal_t lit = CLAUSE_get(clause, lit_i);
+
+            satisfied    |= TRIAL_literal_is_true(trial, lit)  || VARIABLES_literal_is_false(&seen, lit);
+            strengthened |= TRIAL_literal_is_false(trial, lit) || VARIABLES_literal_is_true(&seen, lit);
+
+            VARIABLES_assert_literal(&seen, lit);
+        }
+
+        for (size_t lit_i = 0U; lit_i < CLAUSE_size(clause); ++lit_i)
+        {
+            VARIABLES_remove_literal(&seen, CLAUSE_get(clause, lit_i));
+        }
+
+        if (!satisfied && strengthened)
+        {
+            PROOF_begin(proof, false /*deletion*/, CLAUSE_size(clause));
+
+            for (size_t lit_i = 0U; lit_i < CLAUSE_size(clause); ++lit_i)
+            {
+                literal_t lit = CLAUSE_get(clause, lit_i);
+
+                if (TRIAL_literal_is_undef(trial, lit) && !VARIABLES_literal_is_true(&seen, lit))
+                {
+                    PROOF_literal(proof, lit);
+                    VARIABLES_assert_literal(&seen, lit);
+                }
+            }
+
+            PROOF_end(proof);
+
+            for (size_t lit_i = 0U; lit_i < CLAUSE_size(clause); ++lit_i)
+            {
+                VARIABLES_remove_literal(&seen, CLAUSE_get(clause, lit_i));
+            }
+        }
+
+        // Unit clauses are kept, as DRAT checkers ignore their deletion:
+        if ((satisfied || strengthened) && CLAUSE_size(clause) > 1U)
+        {
+            PROOF_clause(proof, clause, true /*deletion*/);
+        }
+    }
+}
+
+//
+// Single transition of the DPLL algorithm
+//
+sat_t dpll_step(TRIAL* trial, FORMULA* formula)
+{
+    // Optimize the search by unit propagation:
+    dpll_exhaustive_unit_propagate(trial, formula);
+
+    #ifndef NDEBUG
+    printf(YELLOW"[PROPAGATE ] "RESET);
+    dpll_print_progress(trial, formula);
+    #endif
+
+    if (TRIAL_formula_is_unsat(trial))
+    {
+        trial->stats.conflicts += 1U;
+
+        if (trial->proof != NULL)
+        {
+            dpll_proof_conflict(trial);
+        }
+
+        if (TRIAL_cur_level(trial) == 0U)
+        {
+            // Formula is unsatisfiable with no substitutions => UNSAT.
+            return UNSAT;
+        }
+
+        // Pop substitution from the trial:
+        dpll_apply_backtrack(trial, formula);
+
+        #ifndef NDEBUG
+        printf(YELLOW"[BACKTRACK ] "RESET);
+        TRIAL_print(trial);
+        #endif
+
+        return UNDEF;
+    }
+
+    // NOTE: the trial may also hold assumptions and units
+    //       that are not a part of the preprocessed formula.
+    if (VARIABLES_contained(&formula->variables, &trial->variables))
+    {
+        // Explicitly get the valuation that satisfies the formula => SAT.
+        return SAT;
+    }
+
+    // Use decision to obtain substitution:
+    dpll_apply_decide(trial, formula);
+
+    return UNDEF;
+}
+
+//
+// Local search phases
+//
+
+// Run the first burst over the preprocessed formula.
+// NOTE: all the memory of the bursts is allocated here.
+void dpll_phases_start(PHASES* phases, TRIAL* trial, const FORMULA* formula,
+                       const LIMITS* limits, double deadline)
+{
+    LOCAL_SEARCH_init(&phases->ls, formula, phases->seed);
+    LOCAL_SEARCH_randomize(&phases->ls);
+
+    phases->started        = true;
+    phases->initial_unsat  = phases->ls.num_unsat;
+    phases->next_conflicts = phases->conflicts_interval;
+
+    LOCAL_SEARCH_run(&phases->ls, phases->flips,
+        (limits != NULL)? limits->interrupted : NULL,
+        (limits != NULL && limits->seconds > 0.0)? deadline : 0.0);
+    phases->bursts += 1U;
+
+    trial->phases     = phases->ls.best_values;
+    trial->num_phases = phases->ls.num_variables;
+}
+
+// Continue the local search from the best assignment once the burst interval has passed.
+void dpll_phases_update(PHASES* phases, const TRIAL* trial, const LIMITS* limits, double deadline)
+{
+    if (phases->conflicts_interval == 0U || trial->stats.conflicts < phases->next_conflicts)
+    {
+        return;
+    }
+
+    phases->next_conflicts = trial->stats.conflicts + phases->conflicts_interval;
+
+    LOCAL_SEARCH_restore_best(&phases->ls);
+    LOCAL_SEARCH_run(&phases->ls, phases->flips,
+        (limits != NULL)? limits->interrupted : NULL,
+        (limits != NULL && limits->seconds > 0.0)? deadline : 0.0);
+    phases->bursts += 1U;
+}
+
+//
+// XOR constraints
+//
+
+// Detect the XOR constraints encoded in the initial formula and attach their system to the trial.
+// NOTE: the constraints are implied by the initial formula, so they hold under any preprocessing.
+void dpll_xor_start(TRIAL* trial, const FORMULA* initial, XOR_SYSTEM* xors)
+{
+    XOR_CONSTRAINT* constraints;
+    size_t num_constraints = XOR_detect(initial, &constraints);
+
+    if (num_constraints != 0U)
+    {
+        XOR_SYSTEM_init(xors, constraints, num_constraints,
+            VARIABLES_max_value(&initial->variables), trial->arena);
+
+        for (size_t lit_i = 0U; lit_i < trial->literals.size; ++lit_i)
+        {
+            XOR_SYSTEM_assign(xors, trial->literals.array[lit_i]);
+        }
+
+        trial->xors = xors;
+        trial->stats.xor_rows = num_constraints;
+    }
+
+    free(constraints);
+}
+
+//
+// Cardinality constraints
+//
+
+// Attach the cardinality constraints of the initial formula to the trial
+// and propagate them under the level-zero assignment.
+// NOTE: the variables of the constraints become variables of the resulting formula,
+//       so that they are decided and the model covers them.
+//
+// Return UNSAT if the constraints are violated at level zero.
+sat_t dpll_cardinality_start(TRIAL* trial, const FORMULA* initial, FORMULA* resulting,
+                             CARDINALITY_SYSTEM* cardinalities)
+{
+    CARDINALITY_SYSTEM_init(cardinalities, initial, trial->arena);
+
+    for (size_t lit_i = 0U; lit_i < trial->literals.size; ++lit_i)
+    {
+        CARDINALITY_SYSTEM_assign(cardinalities, trial->literals.array[lit_i]);
+    }
+
+    trial->cardinalities = cardinalities;
+    trial->stats.cardinalities = cardinalities->num_constraints;
+
+    for (size_t lit_i = 0U; lit_i < cardinalities->start[cardinalities->num_constraints]; ++lit_i)
+    {
+        literal_t var = cardinalities->literals[lit_i] & ~LITERAL_CONTRARY_BIT;
+
+        VARIABLES_assert_literal(&resulting->variables, var);
+        if (TRIAL_literal_is_undef(trial, var))
+        {
+            VARIABLES_assert_literal(&trial->unselected, var);
+        }
+    }
+
+    // Every true literal of the trial is notified once again:
+    for (size_t lit_i = 0U; lit_i < trial->literals.size && !trial->conflict_flag; ++lit_i)
+    {
+        dpll_notify_cardinalities(trial, trial->literals.array[lit_i] & ~LITERAL_DECISION_BIT);
+    }
+
+    // Constraints with zero bounds are reached with no true literals:
+    for (size_t card_i = 0U; card_i < cardinalities->num_constraints; ++card_i)
+    {
+        if (cardinalities->bounds[card_i] != 0U)
+        {
+            continue;
+        }
+
+        for (uint32_t lit_i = cardinalities->start[card_i]; lit_i < cardinalities->start[card_i + 1U]; ++lit_i)
+        {
+            literal_t lit = cardinalities->literals[lit_i];
+
+            if (TRIAL_literal_is_true(trial, lit))
+            {
+                trial->conflict_flag = true;
+            }
+            else if (TRIAL_literal_is_undef(trial, lit))
+            {
+                TRIAL_add_to_assertion_queue(trial, lit ^ LITERAL_CONTRARY_BIT);
+            }
+        }
+    }
+
+    if (!trial->conflict_flag)
+    {
+        dpll_exhaustive_unit_propagate(trial, resulting);
+    }
+
+    return trial->conflict_flag? UNSAT : UNDEF;
+}
+
+//
+// Lucky assignments
+//
+
+// Greedy fill: decide every variable in the given order and polarity with unit propagation in between.
+// There is no backtracking: the fill is abandoned on the first conflict.
+//
+// Return true if the fill satisfies the formula (the assignment is left in the trial).
+bool dpll_lucky_fill(TRIAL* trial, FORMULA* formula, bool positive, bool forward)
+{
+    size_t num_variables = VARIABLES_max_value(&formula->variables);
+
+    for (size_t var_i = 1U; var_i <= num_variables; ++var_i)
+    {
+        literal_t lit = positive? 0U : LITERAL_CONTRARY_BIT;
+        LITERAL_VALUE_Set(lit, forward? var_i : num_variables + 1U - var_i);
+
+        // Skip the variables that are assigned or not used by the formula:
+        if (!TRIAL_literal_is_undef(trial, lit) || VARIABLES_literal_is_undef(&formula->variables, lit))
+        {
+            continue;
+        }
+
+        dpll_assert_literal(trial, formula, lit | LITERAL_DECISION_BIT);
+        trial->stats.lucky_decisions += 1U;
+
+        dpll_exhaustive_unit_propagate(trial, formula);
+
+        if (TRIAL_formula_is_unsat(trial))
+        {
+            trial->stats.lucky_conflicts += 1U;
+            dpll_backtrack_to_level(trial, 0U);
+            return false;
+        }
+    }
+
+    if (VARIABLES_contained(&formula->variables, &trial->variables))
+    {
+        return true;
+    }
+
+    dpll_backtrack_to_level(trial, 0U);
+    return false;
+}
+
+// Lanes of the constant candidates evaluated before the fills:
+#define LUCKY_LANE_FALSE  0U
+#define LUCKY_LANE_TRUE   1U
+#define LUCKY_LANE_PHASES 2U
+
+// Decide every unassigned variable by the value of the lane with unit propagation in between.
+//
+// Return true if the lane assignment satisfies the formula (the assignment is left in the trial).
+bool dpll_lucky_install(TRIAL* trial, FORMULA* formula, const BITPARALLEL* candidates, size_t lane)
+{
+    for (size_t var = 1U; var <= candidates->num_variables; ++var)
+    {
+        literal_t lit = BITPARALLEL_get(candidates, var, lane)? 0U : LITERAL_CONTRARY_BIT;
+        LITERAL_VALUE_Set(lit, var);
+
+        if (!TRIAL_literal_is_undef(trial, lit) || VARIABLES_literal_is_undef(&formula->variables, lit))
+        {
+            continue;
+        }
+
+        dpll_assert_literal(trial, formula, lit | LITERAL_DECISION_BIT);
+        trial->stats.lucky_decisions += 1U;
+
+        dpll_exhaustive_unit_propagate(trial, formula);
+
+        // XOR and cardinality constraints are not evaluated in the lanes:
+        if (TRIAL_formula_is_unsat(trial))
+        {
+            trial->stats.lucky_conflicts += 1U;
+            dpll_backtrack_to_level(trial, 0U);
+            return false;
+        }
+    }
+
+    if (VARIABLES_contained(&formula->variables, &trial->variables))
+    {
+        return true;
+    }
+
+    dpll_backtrack_to_level(trial, 0U);
+    return false;
+}
+
+// Evaluate the constant candidates (all-false, all-true and the local search phases)
+// in the lanes of a single bit-parallel pass over the clauses and install the first satisfying one.
+//
+// Return true if a candidate satisfies the formula (the assignment is left in the trial).
+bool dpll_lucky_candidates(TRIAL* trial, FORMULA* formula)
+{
+    BITPARALLEL candidates;
+    BITPARALLEL_init(&candidates, formula, 1U);
+
+    size_t num_candidates = (trial->phases != NULL)? LUCKY_LANE_PHASES + 1U : LUCKY_LANE_PHASES;
+
+    for (size_t var = 1U; var <= candidates.num_variables; ++var)
+    {
+        BITPARALLEL_set(&candidates, var, LUCKY_LANE_TRUE, true);
+
+        if (trial->phases != NULL && var <= trial->num_phases)
+        {
+            BITPARALLEL_set(&candidates, var, LUCKY_LANE_PHASES, trial->phases[var]);
+        }
+    }
+
+    uint32_t unsat[64U];
+    BITPARALLEL_evaluate(&candidates, unsat);
+
+    bool satisfied = false;
+    for (size_t lane = 0U; lane < num_candidates && !satisfied; ++lane)
+    {
+        satisfied = unsat[lane] == 0U && dpll_lucky_install(trial, formula, &candidates, lane);
+    }
+
+    BITPARALLEL_free(&candidates);
+
+    return satisfied;
+}
+
+// Try the cheap assignments that satisfy many practical formulas:
+// the constant candidates checked in bit-parallel lanes,
+// then all-false and all-true, filled in the forward and the backward variable order.
+// NOTE: a fill that runs into no conflict is a model, so the plain all-false and all-true
+//       assignments are covered by the fills of the respective polarity.
+sat_t dpll_lucky(TRIAL* trial, FORMULA* formula)
+{
+    if (dpll_lucky_candidates(trial, formula))
+    {
+        return SAT;
+    }
+
+    for (unsigned strategy = 0U; strategy < 4U; ++strategy)
+    {
+        bool positive = strategy & 1U;
+        bool forward  = !(strategy & 2U);
+
+        if (dpll_lucky_fill(trial, formula, positive, forward))
+        {
+            return SAT;
+        }
+    }
+
+    return UNDEF;
+}
+
+//
+// Memory accounting
+//
+
+// Bytes held by the search state.
+void dpll_memory_usage(const TRIAL* trial, const FORMULA* formula, MEMORY_USAGE* usage)
+{
+    MEMORY_USAGE_init(usage);
+
+    usage->bytes[MEMORY_CLAUSES] = formula->clauses.capacity * sizeof(CLAUSE);
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        usage->bytes[MEMORY_CLAUSES] += FORMULA_get(formula, cls_i)->literals.capacity * sizeof(literal_t);
+    }
+
+    const WATCH_LIST* wl = &trial->wl;
+
+    usage->bytes[MEMORY_WATCHES] = 2U*wl->num_literals * sizeof(WATCHED_STORAGE);
+    for (size_t i = 0U; i < 2U*wl->num_literals; ++i)
+    {
+        usage->bytes[MEMORY_WATCHES] += wl->clause_lists[i].capacity * sizeof(const CLAUSE*);
+    }
+
+    usage->bytes[MEMORY_TRAIL] =
+        (trial->literals.capacity + trial->assertion_queue.capacity) * sizeof(literal_t) +
+        SCAN_NUM_VALUES + SCAN_VALUES_PADDING;
+
+    usage->bytes[MEMORY_OCCURRENCES] = wl->occurrence_bytes;
+
+    if (trial->xors != NULL)
+    {
+        usage->bytes[MEMORY_CLAUSES] += trial->xors->num_rows * trial->xors->num_words * sizeof(uint64_t);
+    }
+
+    if (trial->cardinalities != NULL)
+    {
+        const CARDINALITY_SYSTEM* cs = trial->cardinalities;
+
+        usage->bytes[MEMORY_CLAUSES] += cs->start[cs->num_constraints] * sizeof(literal_t) +
+            3U * cs->num_constraints * sizeof(uint32_t);
+        usage->bytes[MEMORY_OCCURRENCES] += (CARDINALITY_NUM_INDICES + cs->start[cs->num_constraints]) * sizeof(uint32_t);
+    }
+}
+
+// Estimate the bytes of the search state before it is built.
+// NOTE: the stacks grow by doubling, hence the factor of two.
+size_t dpll_memory_estimate(const FORMULA* formula)
+{
+    size_t num_literals = VARIABLES_max_value(&formula->variables);
+
+    size_t occurrences = 0U;
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        occurrences += CLAUSE_size(FORMULA_get(formula, cls_i));
+    }
+
+    size_t clauses = 2U * (FORMULA_size(formula) * sizeof(CLAUSE) + occurrences * sizeof(literal_t));
+    size_t watches = 2U*num_literals * sizeof(WATCHED_STORAGE) + occurrences * sizeof(const CLAUSE*);
+    size_t trail   = 3U*num_literals * sizeof(literal_t) + SCAN_NUM_VALUES + SCAN_VALUES_PADDING;
+
+    return clauses + watches + trail + 2U*num_literals * sizeof(size_t);
+}
+
+// Check whether the process fits into the memory limit
+// with the given number of bytes yet to be allocated.
+bool dpll_memory_fits(const LIMITS* limits, size_t bytes)
+{
+    if (limits == NULL || limits->memory == 0U)
+    {
+        return true;
+    }
+
+    return MEMORY_rss() + bytes <= limits->memory;
+}
+
+//
+// Search initialization
+//
+
+// Initialize the trial and preprocess the formula under the assumptions.
+// The search state comes from the region (if not NULL).
+// NOTE: the trial and the resulting formula are to be freed by the caller.
+sat_t dpll_init_search(const FORMULA* initial, FORMULA* resulting, TRIAL* trial, ARENA* arena,
+                       const literal_t* assumptions, size_t num_assumptions)
+{
+    // NOTE: variables of the formula are not necessarily numbered contiguously.
+    TRIAL_init(trial, VARIABLES_max_value(&initial->variables), arena);
+
+    for (size_t lit_i = 0U; lit_i < num_assumptions; ++lit_i)
+    {
+        if (!TRIAL_assume(trial, assumptions[lit_i]))
+        {
+            dpll_formula_init(resulting, trial);
+            return UNSAT;
+        }
+    }
+
+    // Perform initial preprocessing for the formula:
+    // NOTE: it is required to initialize invariants
+    //       for the Two Watch Literal Scheme
+    PROFILE_BEGIN(PROFILE_PREPROCESS);
+
+    sat_t sat_flag = dpll_preprocess_formula(initial, resulting, trial);
+
+    PROFILE_END(PROFILE_PREPROCESS);
+
+    return sat_flag;
+}
+
+//
+// General solver algorithm
+//
+
+// Solve the formula.
+// The satisfying assignment is stored into model (if not NULL),
+// the search statistics are stored into stats (if not NULL),
+// the progress is reported periodically (if progress is not NULL).
+// The decision polarity is guided by local search bursts (if phases is not NULL).
+// The search is abandoned with UNDEF result once it exceeds the limits (if not NULL).
+// The search state comes from the region (if not NULL), which is reset afterwards,
+// otherwise from a region of its own.
+// The refutation is logged into the proof (if not NULL).
+sat_t dpll_solve(const FORMULA* initial_formula, VARIABLES* model, STATS* stats, PROGRESS* progress,
+                 PHASES* phases, const LIMITS* limits, ARENA* arena, PROOF* proof)
+{
+    // Time budget covers the preprocessing:
+    double deadline = TIME_now() + ((limits != NULL)? limits->seconds : 0.0);
+
+    // Do not build the search state that does not fit into the memory:
+    if (!dpll_memory_fits(limits, dpll_memory_estimate(initial_formula)))
+    {
+        if (stats != NULL)
+        {
+            STATS_init(stats);
+        }
+
+        return UNDEF;
+    }
+
+    ARENA local_arena;
+    if (arena == NULL)
+    {
+        ARENA_init(&local_arena, 0U);
+    }
+
+    // Assertion trial and the preprocessed formula:
+    TRIAL trial;
+    FORMULA formula;
+
+    // Satisfiability status:
+    sat_t sat_flag = dpll_init_search(initial_formula, &formula, &trial,
+        (arena != NULL)? arena : &local_arena, NULL, 0U);
+
+    if (phases != NULL && sat_flag == UNDEF)
+    {
+        dpll_phases_start(phases, &trial, &formula, limits, deadline);
+    }
+
+    // Gauss-Jordan reasoning has no clausal justification, so it is off when the proof is logged:
+    XOR_SYSTEM xors;
+    if (proof == NULL && sat_flag == UNDEF)
+    {
+        dpll_xor_start(&trial, initial_formula, &xors);
+    }
+
+    // The clauses alone may be satisfied, but the cardinality constraints are not checked yet:
+    CARDINALITY_SYSTEM cardinalities;
+    if (FORMULA_num_cardinalities(initial_formula) != 0U && sat_flag != UNSAT)
+    {
+        sat_flag = dpll_cardinality_start(&trial, initial_formula, &formula, &cardinalities);
+    }
+
+    if (proof != NULL)
+    {
+        LIT_STORAGE_reserve(&proof->pending,
+            dpll_proof_pending_capacity(VARIABLES_max_value(&initial_formula->variables)));
+    }
+
+    if (proof != NULL)
+    {
+        dpll_proof_preprocess(proof, initial_formula, &trial, sat_flag);
+        trial.proof = proof;
+    }
+
+    // Satisfiable formulas often need no search at all:
+    if (sat_flag == UNDEF)
+    {
+        sat_flag = dpll_lucky(&trial, &formula);
+    }
+
+    #ifdef DPLL_ALLOC_GUARD
+    // All the search memory is to be allocated by now (the lucky candidates release their own):
+    size_t allocations_before = alloc_thread_allocations;
+    size_t frees_before       = alloc_thread_frees;
+    #endif
+
+    // NOTE: the search performs no allocations, so the memory is checked only once.
+    dpll_memory_usage(&trial, &formula, &trial.stats.memory);
+
+    bool stopped = !dpll_memory_fits(limits, 0U);
+
+    #ifndef NDEBUG
+    printf(YELLOW"[PREPROCESS] "RESET);
+    dpll_print_progress(&trial, &formula);
+    #endif
+
+    // DPLL algorithm:
+    while (sat_flag == UNDEF && !stopped)
+    {
+        sat_flag = dpll_step(&trial, &formula);
+
+        if (progress != NULL)
+        {
+            PROGRESS_update(progress, &trial.stats, TRIAL_cur_level(&trial));
+        }
+
+        if (phases != NULL && sat_flag == UNDEF)
+        {
+            dpll_phases_update(phases, &trial, limits, deadline);
+        }
+
+        stopped = LIMITS_reached(limits, &trial.stats, deadline);
+    }
+
+    #ifdef DPLL_ALLOC_GUARD
+    if (alloc_thread_allocations != allocations_before || alloc_thread_frees != frees_before)
+    {
+        fprintf(stderr, "[dpll_solve] %zu allocator calls and %zu frees during search\n",
+            alloc_thread_allocations - allocations_before, alloc_thread_frees - frees_before);
+        exit(EXIT_FAILURE);
+    }
+    #endif
+
+    if (sat_flag == SAT && model != NULL)
+    {
+        *model = trial.variables;
+    }
+
+    if (stats != NULL)
+    {
+        *stats = trial.stats;
+    }
+
+    if (phases != NULL && phases->started)
+    {
+        LOCAL_SEARCH_free(&phases->ls);
+    }
+
+    // The whole search state is released at once:
+    if (arena != NULL)
+    {
+        ARENA_reset(arena);
+    }
+    else
+    {
+        ARENA_free(&local_arena);
+    }
+
+    return sat_flag;
+}
+
+//==========================//
+// probSAT search procedure //
+//==========================//
+
+// Search for a satisfying assignment with at most max_flips flips (zero for no flip limit).
+// Only the time limit and the interruption flag of the limits (if not NULL) are respected.
+// The satisfying assignment is stored into model (if not NULL),
+// the number of flips is stored into flips (if not NULL).
+//
+// Return SAT or UNDEF: local search is unable to prove unsatisfiability.
+sat_t local_search_solve(const FORMULA* formula, VARIABLES* model, uint64_t max_flips, uint64_t seed,
+                         const LIMITS* limits, uint64_t* flips)
+{
+    double deadline = (limits != NULL && limits->seconds > 0.0)? TIME_now() + limits->seconds : 0.0;
+
+    LOCAL_SEARCH ls;
+    bool satisfiable = LOCAL_SEARCH_init(&ls, formula, seed);
+
+    sat_t sat_flag = UNDEF;
+    if (satisfiable)
+    {
+        LOCAL_SEARCH_randomize(&ls);
+
+        bool satisfied = LOCAL_SEARCH_run(&ls, max_flips, (limits != NULL)? limits->interrupted : NULL, deadline);
+
+        sat_flag = satisfied? SAT : UNDEF;
+    }
+
+    if (sat_flag == SAT && model != NULL)
+    {
+        VARIABLES_init(model);
+
+        for (size_t var = 1U; var <= ls.num_variables; ++var)
+        {
+            literal_t lit = ls.values[var]? 0U : LITERAL_CONTRARY_BIT;
+            LITERAL_VALUE_Set(lit, var);
+
+            VARIABLES_assert_literal(model, lit);
+        }
+    }
+
+    if (flips != NULL)
+    {
+        *flips = ls.flips;
+    }
+
+    LOCAL_SEARCH_free(&ls);
+
+    return sat_flag;
+}
+
+#endif // DPLL_SOLVER_H
@@ -25,6 +25,7 @@
 #include <assert.h>
 
 #include "utils.h"
+#include "arena.h"
 
 //================//
 // Data structure //
@@ -41,6 +42,12 @@ typedef struct
     // Maximum possible size for allocated chunk of memory (measured in elements):
     size_t capacity;
 
+    // Capacity the stack never shrinks below:
+    size_t reserved;
+
+    // Region the array comes from (NULL for the heap):
+    ARENA* arena;
+
     // Comparators:
     bool (*comp_eq)(const DATA_T* el1, const DATA_T* el2);
     bool (*comp_lt)(const DATA_T* el1, const DATA_T* el2);
@@ -86,6 +93,8 @@ void METHOD(init)(
     // Initialize size and capacity:
     stack->size = 0U;
     stack->capacity = 8U;
+    stack->reserved = 0U;
+    stack->arena    = NULL;
 
     // Allocate stack of size one:
     stack->array = calloc(8U, sizeof(DATA_T));
@@ -103,7 +112,32 @@ void METHOD(init)(
     stack->sorted = sorted;
 }
 
+// Initialize stack with the memory coming from the region.
+// NOTE: the array is allocated on the first push.
+void METHOD(init_arena)(
+    DATA_STRUCTURE* stack,
+    ARENA* arena,
+    bool (*comp_eq)(const DATA_T* el1, const DATA_T* el2),
+    bool (*comp_lt)(const DATA_T* el1, const DATA_T* el2),
+    bool sorted)
+{
+    assert(stack != NULL);
+    assert(arena != NULL);
+
+    stack->array    = NULL;
+    stack->size     = 0U;
+    stack->capacity = 0U;
+    stack->reserved = 0U;
+    stack->arena    = arena;
+
+    stack->comp_eq = comp_eq;
+    stack->comp_lt = comp_lt;
+
+    stack->sorted = sorted;
+}
+
 // Deallocate stack memory:
+// NOTE: memory of the region is released with the region itself.
 void METHOD(free)(DATA_STRUCTURE* stack)
 {
     assert(stack != NULL);
@@ -113,7 +147,10 @@ void METHOD(free)(DATA_STRUCTURE* stack)
         "[%s] Unable to free an invalid stack (possible double free)\n",
         METHOD_STR(free));
 
-    free(stack->array);
+    if (stack->arena == NULL)
+    {
+        free(stack->array);
+    }
 
     // Mark stack array as invalid:
     // So that OK will raise error:
@@ -122,6 +159,52 @@ void METHOD(free)(DATA_STRUCTURE* stack)
     stack->size     = 0xAAAAAAAAU;
 }
 
+// Reallocate the array to the new capacity.
+// NOTE: this function is for internal use only.
+DATA_T* METHOD(realloc)(DATA_STRUCTURE* stack, size_t new_capacity)
+{
+    if (stack->arena != NULL)
+    {
+        return ARENA_realloc(stack->arena, stack->array,
+            stack->capacity * sizeof(DATA_T), new_capacity * sizeof(DATA_T));
+    }
+
+    return realloc(stack->array, new_capacity * sizeof(DATA_T));
+}
+
+// Preallocate memory for the given number of elements.
+// NOTE: the stack never shrinks below the reserved capacity,
+//       so that the stack of at most this size performs no allocations.
+void METHOD(reserve)(DATA_STRUCTURE* stack, size_t capacity)
+{
+    assert(stack != NULL);
+
+    VERIFY_CONTRACT(
+        METHOD(ok)(stack),
+        "[%s] Unable to reserve memory for an invalid stack\n",
+        METHOD_STR(reserve));
+
+    if (capacity > stack->reserved)
+    {
+        stack->reserved = capacity;
+    }
+
+    if (capacity <= stack->capacity)
+    {
+        return;
+    }
+
+    DATA_T* new_array = METHOD(realloc)(stack, capacity);
+    VERIFY_CONTRACT(
+        new_array != NULL,
+        "[%s] Unable to reallocate memory for stack of new capacity %zu\n",
+        METHOD_STR(reserve),
+        capacity);
+
+    stack->array    = new_array;
+    stack->capacity = capacity;
+}
+
 #define RESIZE_ONEUP   1U
 #define RESIZE_ONEDOWN 0U
 // Perform a resize operation.
@@ -144,7 +227,8 @@ void METHOD(resize)(DATA_STRUCTURE* stack, bool upscale)
     {
         new_capacity = (stack->size < 8U)? 8U : (2U * stack->capacity);
     }
-    else if (!upscale && new_size < stack->capacity / 8U)
+    else if (!upscale && new_size < stack->capacity / 8U && stack->capacity / 2U >= stack->reserved &&
+             stack->arena == NULL)
     {
         new_capacity = stack->capacity / 2U;
     }
@@ -155,7 +239,7 @@ void METHOD(resize)(DATA_STRUCTURE* stack, bool upscale)
     }
 
     // Allocate new array:
-    DATA_T* new_array = realloc(stack->array, new_capacity * sizeof(DATA_T));
+    DATA_T* new_array = METHOD(realloc)(stack, new_capacity);
     VERIFY_CONTRACT(
         new_capacity == 0U || new_array != NULL,
         "[%s] Unable to reallocate memory for stack of new capacity %zu\n",
@@ -417,7 +501,7 @@ void METHOD(insert)(DATA_STRUCTURE* stack, DATA_T element, size_t index)
     METHOD(resize)(stack, RESIZE_ONEUP);
 
     // Move element one right:
-    for (size_t copy_i = stack->size; index < copy_i; copy_i--)
+    for (size_t copy_i = stack->size - 1U; index < copy_i; copy_i--)
     {
         stack->array[copy_i] = stack->array[copy_i - 1U];
     }
@@ -4,6 +4,8 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <time.h>
 
 //====================//
 // Input verification //
@@ -53,4 +55,13 @@
 
 #define STR(token) #token
 
+// Monotonic time in seconds:
+double TIME_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
 #endif // DPLL_UTILS_H
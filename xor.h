@@ -0,0 +1,381 @@
+// No copyright. Vladislav Aleinik, 2023
+#ifndef DPLL_XOR_H
+#define DPLL_XOR_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "formula.h"
+
+//==========================//
+// XOR constraint detection //
+//==========================//
+
+// Constraint x1 ^ ... ^ xk = rhs is encoded in CNF by the 2^(k-1) clauses over x1..xk
+// forbidding the assignments of the wrong parity: the clause with the negated variables N
+// forbids the assignment with exactly the variables N true, so all the clauses agree on |N| mod 2.
+#define XOR_MAX_SIZE 8U
+
+typedef struct
+{
+    // Sorted variables of the clause:
+    uint16_t vars[XOR_MAX_SIZE];
+    uint32_t size;
+
+    // Bit i is set if the variable vars[i] is negated:
+    uint32_t negated;
+} XOR_KEY;
+
+int XOR_KEY_cmp(const void* el1, const void* el2)
+{
+    const XOR_KEY* key1 = el1;
+    const XOR_KEY* key2 = el2;
+
+    if (key1->size != key2->size)
+    {
+        return (key1->size < key2->size)? -1 : 1;
+    }
+
+    int vars = memcmp(key1->vars, key2->vars, sizeof(key1->vars));
+    if (vars != 0)
+    {
+        return vars;
+    }
+
+    return (key1->negated < key2->negated)? -1 : (key1->negated > key2->negated);
+}
+
+// Build the key of a clause of distinct variables.
+//
+// Return false if the clause is not a part of an XOR encoding.
+bool XOR_KEY_init(XOR_KEY* key, const CLAUSE* clause)
+{
+    size_t size = CLAUSE_size(clause);
+    if (size < 2U || size > XOR_MAX_SIZE)
+    {
+        return false;
+    }
+
+    memset(key->vars, 0, sizeof(key->vars));
+    key->size    = size;
+    key->negated = 0U;
+
+    literal_t sorted[XOR_MAX_SIZE];
+    for (size_t lit_i = 0U; lit_i < size; ++lit_i)
+    {
+        literal_t lit = CLAUSE_get(clause, lit_i);
+
+        // Insertion sort by variable:
+        size_t pos = lit_i;
+        for (; pos > 0U && LITERAL_VALUE_Get(sorted[pos - 1U]) > LITERAL_VALUE_Get(lit); --pos)
+        {
+            sorted[pos] = sorted[pos - 1U];
+        }
+
+        sorted[pos] = lit;
+    }
+
+    for (size_t lit_i = 0U; lit_i < size; ++lit_i)
+    {
+        key->vars[lit_i] = LITERAL_VALUE_Get(sorted[lit_i]);
+
+        if (lit_i > 0U && key->vars[lit_i] == key->vars[lit_i - 1U])
+        {
+            return false;
+        }
+
+        if (sorted[lit_i] & LITERAL_CONTRARY_BIT)
+        {
+            key->negated |= 1U << lit_i;
+        }
+    }
+
+    return true;
+}
+
+// Constraint found in the formula:
+typedef struct
+{
+    uint16_t vars[XOR_MAX_SIZE];
+    uint32_t size;
+    bool     rhs;
+} XOR_CONSTRAINT;
+
+// Find the XOR constraints encoded by complete clause sets.
+//
+// Return the number of constraints stored into the array (to be freed by the caller).
+size_t XOR_detect(const FORMULA* formula, XOR_CONSTRAINT** constraints)
+{
+    XOR_KEY* keys = malloc((FORMULA_size(formula) + 1U) * sizeof(XOR_KEY));
+    VERIFY_CONTRACT(keys != NULL,
+        "[%s] Unable to allocate keys of %zu clauses\n", "XOR_detect", FORMULA_size(formula));
+
+    size_t num_keys = 0U;
+    for (size_t cls_i = 0U; cls_i < FORMULA_size(formula); ++cls_i)
+    {
+        if (XOR_KEY_init(&keys[num_keys], FORMULA_get(formula, cls_i)))
+        {
+            num_keys += 1U;
+        }
+    }
+
+    qsort(keys, num_keys, sizeof(XOR_KEY), XOR_KEY_cmp);
+
+    // Every group of clauses over the same variables holds at most one constraint of each parity:
+    *constraints = malloc((num_keys + 1U) * sizeof(XOR_CONSTRAINT));
+    VERIFY_CONTRACT(*constraints != NULL,
+        "[%s] Unable to allocate constraints\n", "XOR_detect");
+
+    size_t num_constraints = 0U;
+    for (size_t group = 0U, next = 0U; group < num_keys; group = next)
+    {
+        // Distinct sign patterns of either parity of the negations:
+        size_t patterns[2U] = {0U, 0U};
+
+        for (next = group; next < num_keys && keys[next].size == keys[group].size &&
+             memcmp(keys[next].vars, keys[group].vars, sizeof(keys[group].vars)) == 0; ++next)
+        {
+            if (next == group || keys[next].negated != keys[next - 1U].negated)
+            {
+                patterns[__builtin_parity(keys[next].negated)] += 1U;
+            }
+        }
+
+        size_t complete = (size_t) 1U << (keys[group].size - 1U);
+        for (unsigned parity = 0U; parity < 2U; ++parity)
+        {
+            if (patterns[parity] == complete)
+            {
+                XOR_CONSTRAINT* constraint = &(*constraints)[num_constraints++];
+
+                memcpy(constraint->vars, keys[group].vars, sizeof(constraint->vars));
+                constraint->size = keys[group].size;
+                constraint->rhs  = (parity == 0U);
+            }
+        }
+    }
+
+    free(keys);
+
+    return num_constraints;
+}
+
+//=========================================//
+// Gauss-Jordan elimination of XOR systems //
+//=========================================//
+
+// The constraints are rows of a bit matrix over the variables.
+// Every row with an unassigned variable has a pivot: an unassigned variable
+// that is not present in any other row. Restricted to the unassigned variables,
+// the matrix is then in the reduced row echelon form, so every implied literal
+// shows up as a row with a single unassigned variable and every conflict
+// as a row with no unassigned variables and the wrong parity.
+//
+// Row operations do not change the solutions of the system, so backtracking does not undo them:
+// a pivot stays unassigned when the assignments are undone.
+typedef struct
+{
+    size_t num_rows;
+
+    // Words of a row (and of the assignment masks):
+    size_t num_words;
+
+    uint64_t* rows;
+    uint8_t*  rhs;
+
+    // Pivot variable of every row (zero if every variable of the row is assigned):
+    uint16_t* pivots;
+
+    // Assigned and true variables:
+    uint64_t* assigned;
+    uint64_t* values;
+
+    // Literals implied by the last propagation:
+    literal_t* implied;
+    size_t     num_implied;
+} XOR_SYSTEM;
+
+// Lay out the constraints over the variables 1..num_variables.
+// The system comes from the region.
+void XOR_SYSTEM_init(XOR_SYSTEM* xs, const XOR_CONSTRAINT* constraints, size_t num_constraints,
+                     size_t num_variables, ARENA* arena)
+{
+    xs->num_rows  = num_constraints;
+    xs->num_words = num_variables / 64U + 1U;
+
+    xs->rows     = ARENA_calloc(arena, xs->num_rows * xs->num_words, sizeof(uint64_t));
+    xs->rhs      = ARENA_calloc(arena, xs->num_rows, sizeof(uint8_t));
+    xs->pivots   = ARENA_calloc(arena, xs->num_rows, sizeof(uint16_t));
+    xs->assigned = ARENA_calloc(arena, xs->num_words, sizeof(uint64_t));
+    xs->values   = ARENA_calloc(arena, xs->num_words, sizeof(uint64_t));
+    xs->implied  = ARENA_calloc(arena, xs->num_rows, sizeof(literal_t));
+    VERIFY_CONTRACT(xs->rows != NULL && xs->rhs != NULL && xs->pivots != NULL &&
+                    xs->assigned != NULL && xs->values != NULL && xs->implied != NULL,
+        "[%s] Unable to allocate system of %zu constraints\n", "XOR_SYSTEM_init", num_constraints);
+
+    for (size_t row_i = 0U; row_i < xs->num_rows; ++row_i)
+    {
+        uint64_t* row = &xs->rows[row_i * xs->num_words];
+
+        for (size_t var_i = 0U; var_i < constraints[row_i].size; ++var_i)
+        {
+            uint16_t var = constraints[row_i].vars[var_i];
+
+            row[var / 64U] |= (uint64_t) 1U << (var % 64U);
+        }
+
+        xs->rhs[row_i] = constraints[row_i].rhs;
+    }
+
+    xs->num_implied = 0U;
+}
+
+void XOR_SYSTEM_assign(XOR_SYSTEM* xs, literal_t lit)
+{
+    size_t   var = LITERAL_VALUE_Get(lit);
+    uint64_t bit = (uint64_t) 1U << (var % 64U);
+
+    xs->assigned[var / 64U] |= bit;
+    if (!(lit & LITERAL_CONTRARY_BIT))
+    {
+        xs->values[var / 64U] |= bit;
+    }
+}
+
+void XOR_SYSTEM_unassign(XOR_SYSTEM* xs, literal_t lit)
+{
+    size_t   var = LITERAL_VALUE_Get(lit);
+    uint64_t bit = (uint64_t) 1U << (var % 64U);
+
+    xs->assigned[var / 64U] &= ~bit;
+    xs->values[var / 64U]   &= ~bit;
+}
+
+bool XOR_SYSTEM_is_assigned(const XOR_SYSTEM* xs, size_t var)
+{
+    return (xs->assigned[var / 64U] >> (var % 64U)) & 1U;
+}
+
+// Find an unassigned variable of the row other than the given one (zero if there is none).
+uint16_t XOR_SYSTEM_find_unassigned(const XOR_SYSTEM* xs, size_t row_i, size_t except)
+{
+    const uint64_t* row = &xs->rows[row_i * xs->num_words];
+
+    for (size_t word = 0U; word < xs->num_words; ++word)
+    {
+        uint64_t unassigned = row[word] & ~xs->assigned[word];
+        if (word == except / 64U)
+        {
+            unassigned &= ~((uint64_t) 1U << (except % 64U));
+        }
+
+        if (unassigned != 0U)
+        {
+            return word * 64U + __builtin_ctzll(unassigned);
+        }
+    }
+
+    return 0U;
+}
+
+// Parity of the true variables of the row.
+bool XOR_SYSTEM_row_parity(const XOR_SYSTEM* xs, size_t row_i)
+{
+    const uint64_t* row = &xs->rows[row_i * xs->num_words];
+
+    unsigned parity = 0U;
+    for (size_t word = 0U; word < xs->num_words; ++word)
+    {
+        parity ^= __builtin_parityll(row[word] & xs->values[word]);
+    }
+
+    return parity;
+}
+
+// Make the variable the pivot of the row by eliminating it from every other row.
+void XOR_SYSTEM_pivot(XOR_SYSTEM* xs, size_t row_i, uint16_t var)
+{
+    const uint64_t* row = &xs->rows[row_i * xs->num_words];
+
+    for (size_t other_i = 0U; other_i < xs->num_rows; ++other_i)
+    {
+        uint64_t* other = &xs->rows[other_i * xs->num_words];
+
+        if (other_i == row_i || !((other[var / 64U] >> (var % 64U)) & 1U))
+        {
+            continue;
+        }
+
+        for (size_t word = 0U; word < xs->num_words; ++word)
+        {
+            other[word] ^= row[word];
+        }
+
+        xs->rhs[other_i] ^= xs->rhs[row_i];
+    }
+
+    xs->pivots[row_i] = var;
+}
+
+// Restore the pivots under the current assignment and collect the implied literals.
+//
+// Return false on a conflict.
+bool XOR_SYSTEM_propagate(XOR_SYSTEM* xs)
+{
+    xs->num_implied = 0U;
+
+    // Rows that lost their pivots take new ones:
+    // the elimination changes the other rows, so the rows are inspected afterwards.
+    for (size_t row_i = 0U; row_i < xs->num_rows; ++row_i)
+    {
+        if (xs->pivots[row_i] != 0U && !XOR_SYSTEM_is_assigned(xs, xs->pivots[row_i]))
+        {
+            continue;
+        }
+
+        uint16_t var = XOR_SYSTEM_find_unassigned(xs, row_i, 0U);
+        if (var != 0U)
+        {
+            XOR_SYSTEM_pivot(xs, row_i, var);
+        }
+        else
+        {
+            xs->pivots[row_i] = 0U;
+        }
+    }
+
+    for (size_t row_i = 0U; row_i < xs->num_rows; ++row_i)
+    {
+        uint16_t pivot = xs->pivots[row_i];
+
+        // Fully assigned row:
+        if (pivot == 0U)
+        {
+            if (XOR_SYSTEM_row_parity(xs, row_i) != xs->rhs[row_i])
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        // Row with a single unassigned variable:
+        if (XOR_SYSTEM_find_unassigned(xs, row_i, pivot) == 0U)
+        {
+            bool value = XOR_SYSTEM_row_parity(xs, row_i) ^ xs->rhs[row_i];
+
+            literal_t lit = value? 0U : LITERAL_CONTRARY_BIT;
+            LITERAL_VALUE_Set(lit, pivot);
+
+            xs->implied[xs->num_implied++] = lit;
+        }
+    }
+
+    return true;
+}
+
+#endif // DPLL_XOR_H